@@ -27,12 +27,15 @@
 #include "../src/config.h"
 #include "../src/config_parsers.h"
 #include "benchmark_helpers/startup_helper.h"
+#include "../test/test_helpers/fov_reference.h"
 #include "../src/working_directory_manipulation.h"
 #include "game_logic/fov.h"
+#include <game_logic/fov_table.h>
 #include "../src/asset_loading/load_map.h"
 #include <game_logic/a_star.h>
 #include <asset_loading/load_assets.h>
 #include <ai/default_ai.h>
+#include <game_logic/logic_helpers.h>
 #include <messages/generic_error_response.h>
 
 using namespace std;
@@ -69,10 +72,51 @@ void bench_fov(map_component const &m) {
     }
 
     auto loc = make_tuple(4, 4);
+    fov_scratch scratch;
     auto start = chrono::system_clock::now();
 
     for(int i = 0; i < 1'000'000; i++) {
-        compute_fov_restrictive_shadowcasting(m, loc, false);
+        compute_fov_restrictive_shadowcasting(m, loc, false, scratch);
+    }
+
+    auto end = chrono::system_clock::now();
+
+    spdlog::info("[{}] {:n} µs", __FUNCTION__, chrono::duration_cast<chrono::microseconds>(end-start).count());
+}
+
+void bench_fov_double_reference(map_component const &m) {
+    if(quit) {
+        return;
+    }
+
+    auto loc = make_tuple(4, 4);
+    auto start = chrono::system_clock::now();
+
+    for(int i = 0; i < 1'000'000; i++) {
+        compute_fov_double_reference(m, loc, false);
+    }
+
+    auto end = chrono::system_clock::now();
+
+    spdlog::info("[{}] {:n} µs", __FUNCTION__, chrono::duration_cast<chrono::microseconds>(end-start).count());
+}
+
+void bench_fov_batch(map_component const &m) {
+    if(quit) {
+        return;
+    }
+
+    // town like crowd, 1000 players spread over 50 tiles
+    vector<location> observers;
+    for(int32_t i = 0; i < 1'000; i++) {
+        observers.emplace_back(4 + i % 10, 4 + (i / 10) % 5);
+    }
+    vector<bitset<power(fov_diameter)>> fovs;
+
+    auto start = chrono::system_clock::now();
+
+    for(int i = 0; i < 1'000; i++) {
+        get_fov_batch(m, observers, fovs);
     }
 
     auto end = chrono::system_clock::now();
@@ -145,12 +189,16 @@ void bench_default_ai(map_component &m) {
     }
 
     auto start = chrono::system_clock::now();
-    lotr_player_location_map player_locs{};
 
     for(int i = 0; i < 10'000; i++) {
-        for(auto &npc : m.npcs) {
-            run_ai_on(npc, m, player_locs);
-        }
+        npc_group(m).each([&](entt::entity npc_entity, position_component &position, vitals_component &vitals, ai_component &ai, spawner_link_component &link, npc_component &npc) {
+            auto const previous_loc = position.loc;
+            run_ai_on(position, vitals, ai, link, npc, m);
+
+            if(position.loc != previous_loc) {
+                m.npc_grid.move(npc_entity, previous_loc, position.loc);
+            }
+        });
     }
 
     auto end = chrono::system_clock::now();
@@ -242,16 +290,16 @@ int main(int argc, char **argv) {
     }
 
     entt::registry registry;
-    load_assets(registry, quit);
+    load_assets(registry, 1'000, quit);
 
     auto map_view = registry.view<map_component>();
 
-    optional<map_component> m;
+    map_component *m = nullptr;
     for(auto m_entity : map_view) {
         map_component &mc = map_view.get(m_entity);
 
         if(mc.name == "DedlaenMaze") {
-            m = mc;
+            m = &mc;
         }
     }
 
@@ -261,11 +309,13 @@ int main(int argc, char **argv) {
     }
 
     bench_censor_sensor();
-    bench_fov(m.value());
+    bench_fov(*m);
+    bench_fov_double_reference(*m);
+    bench_fov_batch(*m);
     bench_hashing();
     bench_hash_verify();
-    bench_a_star(m.value());
-    bench_default_ai(m.value());
+    bench_a_star(*m);
+    bench_default_ai(*m);
     bench_serialization();
     bench_rapidjson_without_strlen();
     bench_rapidjson_with_strlen();
@@ -28,25 +28,12 @@ using namespace std;
 using namespace lotr;
 
 [[nodiscard]]
-vector<pc_component*> get_players_in_range(character_component const &npc, map_component const &m, lotr_player_location_map const &player_location_map, int32_t radius) {
-    vector<pc_component*> ret;
+vector<entt::entity> get_players_in_range(location const &loc, map_component &m, int32_t radius) {
+    vector<entt::entity> ret;
 
-    for(int32_t x_radius = -radius; x_radius <= radius; x_radius++) {
-        if(static_cast<int32_t>(get<0>(npc.loc)) - x_radius < 0 || static_cast<int32_t>(get<0>(npc.loc)) - x_radius >= static_cast<int32_t>(m.width)) {
-            continue;
-        }
-
-        for(int32_t y_radius = -radius; y_radius <= radius; y_radius++) {
-            if(static_cast<int32_t>(get<1>(npc.loc)) - y_radius < 0 || static_cast<int32_t>(get<1>(npc.loc)) - y_radius >= static_cast<int32_t>(m.height)) {
-                continue;
-            }
-
-            auto it = player_location_map.find(make_tuple(get<0>(npc.loc) - x_radius, get<1>(npc.loc) - y_radius));
-            if(it != end(player_location_map)) {
-                ret.insert(end(ret), begin(it->second), end(it->second));
-            }
-        }
-    }
+    m.player_grid.for_each_in_range(loc, radius, [&](entt::entity player, location const &) {
+        ret.push_back(player);
+    });
 
     return ret;
 }
@@ -89,63 +76,86 @@ tuple<int32_t, int32_t> direction_to_position_offset(movement_direction directio
 }
 
 
-void move_npc_along_path(npc_component &npc, int num_steps) {
-    auto offset = direction_to_position_offset(npc.paths[npc.current_path_index].direction, num_steps);
-    get<0>(npc.loc) += get<0>(offset);
-    get<1>(npc.loc) += get<1>(offset);
-    npc.steps_remaining_in_path -= num_steps;
+void move_npc_along_path(location &loc, ai_component &ai, int num_steps) {
+    auto offset = direction_to_position_offset(ai.paths[ai.current_path_index].direction, num_steps);
+    get<0>(loc) += get<0>(offset);
+    get<1>(loc) += get<1>(offset);
+    ai.steps_remaining_in_path -= num_steps;
+
+    if(ai.steps_remaining_in_path == 0) {
+        ai.current_path_index++;
+        if(ai.current_path_index >= ai.paths.size()) {
+            ai.current_path_index = 0;
+        }
+        ai.steps_remaining_in_path = ai.paths[ai.current_path_index].steps;
+    }
+}
+
+// shared by the full and coarse ai, so an npc comes home the same way whether a player is watching or not
+void leash_to_spawner(location &loc, vitals_component &vitals, spawner_script const &spawner, bool has_target) {
+    auto distance_from_spawner = distance_between(loc, spawner.loc);
+    if((!has_target && distance_from_spawner > spawner.random_walk_radius) || distance_from_spawner > spawner.leash_radius) {
+        // send leash message
+
+        loc = spawner.loc;
 
-    if(npc.steps_remaining_in_path == 0) {
-        npc.current_path_index++;
-        if(npc.current_path_index >= npc.paths.size()) {
-            npc.current_path_index = 0;
+        if(distance_from_spawner > spawner.leash_radius + 4) {
+            vitals.hp = vitals.max_hp;
+            vitals.mp = vitals.max_mp;
         }
-        npc.steps_remaining_in_path = npc.paths[npc.current_path_index].steps;
     }
 }
 
-void lotr::run_ai_on(npc_component &npc, map_component &m, lotr_player_location_map const &player_location_map) {
-    if(npc.hostility == hostility_never) {
+void lotr::run_ai_on(position_component &position, vitals_component &vitals, ai_component &ai, spawner_link_component const &link, npc_component &npc, map_component &m) {
+    auto &loc = position.loc;
+    auto *spawner = get_spawner(m, link.spawner);
+
+    if(ai.agro_target != entt::null && !m.entities.valid(ai.agro_target)) {
+        ai.agro_target = entt::null;
+    }
+
+    if(ai.hostility == HostilityNever) {
         return;
     }
 
-    pc_component *current_target = nullptr;
-    bool player_on_same_location = player_location_map.find(make_tuple(get<0>(npc.loc), get<1>(npc.loc))) != end(player_location_map);
-    if(!(npc.hostility == hostility_on_hit && npc.agro_target == nullptr) && player_on_same_location) {
-        auto targets_in_range = get_players_in_range(npc, m, player_location_map, 4);
+    entt::entity current_target = entt::null;
+    bool player_on_same_location = false;
+    m.player_grid.for_each_in_range(loc, 0, [&](entt::entity, location const &) { player_on_same_location = true; });
+    if(!(ai.hostility == HostilityOnHit && ai.agro_target == entt::null) && player_on_same_location) {
+        auto targets_in_range = get_players_in_range(loc, m, 4);
 
         if(!targets_in_range.empty()) {
-            current_target = targets_in_range.size() > 1 ? targets_in_range[lotr::random.generate_single_fast(targets_in_range.size() - 1)] : 0;
+            current_target = targets_in_range.size() > 1 ? targets_in_range[lotr::random.generate_single_fast(targets_in_range.size() - 1)] : targets_in_range[0];
         }
     }
 
-    auto move_rate = npc.stats[stat_move];
+    auto move_rate = static_cast<uint64_t>(npc.stats[StatMove]);
     auto num_steps = 0;
-    if(npc.paths.empty()) {
-        num_steps = lotr::random.generate_single_fast(move_rate);
-    } else {
-        num_steps = lotr::random.generate_single_fast(min(move_rate, npc.steps_remaining_in_path));
+    // bounded random with a bound of 0 divides by zero
+    auto const max_steps = ai.paths.empty() ? move_rate : min(move_rate, ai.steps_remaining_in_path);
+    if(max_steps > 0) {
+        num_steps = lotr::random.generate_single_fast(max_steps);
     }
 
     if(lotr::random.one_in_x(100)) {
         check_ground_for_items(npc, m);
     }
 
-    if(current_target != nullptr) {
+    if(current_target != entt::null) {
 
-    } else if(!npc.paths.empty()) {
-        if(npc.is_path_interrupted) {
-            if(get<0>(npc.loc) == get<0>(npc.loc_before_interruption) && get<1>(npc.loc) == get<1>(npc.loc_before_interruption)) {
-                npc.is_path_interrupted = false;
-                move_npc_along_path(npc, num_steps);
+    } else if(!ai.paths.empty()) {
+        if(ai.is_path_interrupted) {
+            if(get<0>(loc) == get<0>(ai.loc_before_interruption) && get<1>(loc) == get<1>(ai.loc_before_interruption)) {
+                ai.is_path_interrupted = false;
+                move_npc_along_path(loc, ai, num_steps);
             } else {
-                auto paths = a_star_path(m, npc.loc, npc.loc_before_interruption);
+                auto paths = a_star_path(m, loc, ai.loc_before_interruption);
                 vector<location> path;
                 path.reserve(fov_max_distance);
 
                 {
-                    auto &next = paths[npc.loc_before_interruption];
-                    while (next != npc.loc) {
+                    auto &next = paths[ai.loc_before_interruption];
+                    while (next != loc) {
                         path.push_back(next);
                         next = paths[next];
                     }
@@ -159,37 +169,87 @@ void lotr::run_ai_on(npc_component &npc, map_component &m, lotr_player_location_
                         continue;
                     }
 
-                    npc.loc = next;
+                    loc = next;
 
                     break;
                 }
             }
         } else {
-            move_npc_along_path(npc, num_steps);
+            move_npc_along_path(loc, ai, num_steps);
         }
     } else {
         //wander
         while(num_steps > 0) {
-            auto x = lotr::random.generate_single(-1l, 1l);
-            auto y = lotr::random.generate_single(-1l, 1l);
+            auto mask = m.tiles.walkable_neighbours(get<0>(loc), get<1>(loc));
+            if(mask == 0) {
+                break;
+            }
 
-            if(tile_is_walkable(m, get<0>(npc.loc) + x, get<1>(npc.loc) + y)) {
-                npc.loc = make_tuple(get<0>(npc.loc) + x, get<1>(npc.loc) + y);
-                num_steps--;
+            // pick a random set bit
+            auto pick = lotr::random.generate_single(0l, static_cast<int64_t>(__builtin_popcount(mask)) - 1);
+            for(; pick > 0; pick--) {
+                mask &= mask - 1;
             }
+
+            auto const &offset = neighbour_offsets[__builtin_ctz(mask)];
+            loc = make_tuple(get<0>(loc) + get<0>(offset), get<1>(loc) + get<1>(offset));
+            num_steps--;
         }
     }
 
-    auto distance_from_spawner = distance_between(npc.loc, npc.spawner->loc);
-    if(npc.paths.empty() && ((current_target == nullptr && distance_from_spawner > npc.spawner->random_walk_radius) ||
-        distance_from_spawner > npc.spawner->leash_radius)) {
-        // send leash message
+    if(spawner == nullptr) {
+        return;
+    }
+
+    if(ai.paths.empty()) {
+        leash_to_spawner(loc, vitals, *spawner, current_target != entt::null);
+    }
+}
 
-        npc.loc = npc.spawner->loc;
+void lotr::run_coarse_ai_on(position_component &position, vitals_component &vitals, ai_component &ai, spawner_link_component const &link, map_component &m) {
+    ai.agro_target = entt::null;
 
-        if(distance_from_spawner > npc.spawner->leash_radius + 4) {
-            npc.stats[stat_hp] = npc.stats[stat_max_hp];
-            npc.stats[stat_mp] = npc.stats[stat_max_mp];
-        }
+    if(ai.hostility == HostilityNever) {
+        return;
+    }
+
+    // pathing npcs keep their place on the path
+    auto *spawner = get_spawner(m, link.spawner);
+    if(spawner == nullptr || !ai.paths.empty()) {
+        return;
+    }
+
+    // no player is within ai_full_radius, so there is nothing to target
+    leash_to_spawner(position.loc, vitals, *spawner, false);
+}
+
+void lotr::run_scheduled_ai(map_component &m, entt::entity npc) {
+    if(!m.entities.valid(npc)) {
+        return;
     }
+
+    auto &position = m.entities.get<position_component>(npc);
+    auto &ai = m.entities.get<ai_component>(npc);
+    auto &npc_data = m.entities.get<npc_component>(npc);
+    auto const previous_loc = position.loc;
+    ai.pending = false;
+
+    bool observed = false;
+    m.player_grid.for_each_in_range(position.loc, m.ai_full_radius, [&observed](entt::entity, location const &) { observed = true; });
+
+    auto interval = ai_action_interval(npc_data, m.tick_length);
+    if(observed) {
+        ai.coarse = false;
+        run_ai_on(position, m.entities.get<vitals_component>(npc), ai, m.entities.get<spawner_link_component>(npc), npc_data, m);
+    } else {
+        ai.coarse = true;
+        run_coarse_ai_on(position, m.entities.get<vitals_component>(npc), ai, m.entities.get<spawner_link_component>(npc), m);
+        interval *= coarse_ai_interval_factor;
+    }
+
+    if(position.loc != previous_loc) {
+        m.npc_grid.move(npc, previous_loc, position.loc);
+    }
+
+    m.timers.schedule(npc, AiTimer, m.tick + interval);
 }
@@ -24,7 +24,14 @@
 using namespace std;
 
 namespace lotr {
-    using lotr_player_location_map = lotr_flat_map <tuple<uint64_t, uint64_t>, vector<pc_component*>>;
-
-    void run_ai_on(npc_component &npc, map_component &m, lotr_player_location_map const &player_location_map);
+    void run_ai_on(position_component &position, vitals_component &vitals, ai_component &ai, spawner_link_component const &link, npc_component &npc, map_component &m);
+    // npcs without players around act this many times less often
+    constexpr uint64_t coarse_ai_interval_factor = 10;
+
+    // cheap stand in for run_ai_on when no player is around: drops the target and leashes npcs that strayed from their spawner
+    // by the same rules as run_ai_on
+    void run_coarse_ai_on(position_component &position, vitals_component &vitals, ai_component &ai, spawner_link_component const &link, map_component &m);
+    // runs the full or coarse ai of an npc whose AiTimer fired, depending on whether a player is within m.ai_full_radius,
+    // and schedules its next action
+    void run_scheduled_ai(map_component &m, entt::entity npc);
 }
@@ -18,21 +18,21 @@
 
 #include "load_assets.h"
 #include <filesystem>
+#include <fstream>
 #include "spdlog/spdlog.h"
 #include "load_item.h"
 #include "load_npc.h"
 #include "load_map.h"
-#include <game_logic/random_helper.h>
 #include <game_logic/logic_helpers.h>
 
 using namespace std;
 using namespace lotr;
 
-#define NPC_STRING_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<string>(); }
+#define NPC_STRING_FIELD(x) if(npc_node[ #x ]) { npc. x = interned_string(npc_node[ #x ].as<string>()); }
 #define NPC_UINT_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<uint32_t>(); }
 #define NPC_BOOL_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<bool>(); }
 
-void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
+void lotr::load_assets(entt::registry &registry, uint32_t tick_length, atomic<bool> const &quit) {
     uint32_t item_count = 0;
     uint32_t npc_count = 0;
     uint32_t map_count = 0;
@@ -96,12 +96,12 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
                 global_npc_component gnpc{};
 
                 gnpc.name = npc.name;
-                gnpc.npc_id = npc.name;
+                gnpc.npc_id = interned_string(npc.name);
                 gnpc.sprite.push_back(npc.gid - m->tilesets[3].firstgid);
-                gnpc.stats.reserve(stat_names.size());
+                gnpc.stats.reserve(stat_name_table.size());
 
-                for(auto &stat : stat_names) {
-                    gnpc.stats.emplace_back(stat, 10);
+                for(auto const &stat : stat_name_table) {
+                    gnpc.stats.emplace_back(string(stat), 10);
                 }
 
                 registry.assign<global_npc_component>(new_entity, move(gnpc));
@@ -126,6 +126,7 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
         }
 
         map_component &m = map_view.get(m_entity);
+        m.tick_length = tick_length;
 
         auto &spawners_layer = m.layers[map_layer_name::Spawners];
         if(spawners_layer.name.empty()) {
@@ -133,6 +134,16 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
             return;
         }
 
+        uint32_t npc_capacity = 0;
+        for(auto layer : {map_layer_name::Spawners, map_layer_name::NPCs}) {
+            for(auto const &object : m.layers[layer].objects) {
+                if(object.gid != 0 && object.script) {
+                    npc_capacity += object.script->max_creatures;
+                }
+            }
+        }
+        reserve_npcs(m, npc_capacity);
+
         for(auto &spawner_object : spawners_layer.objects) {
             if(spawner_object.gid == 0 || !spawner_object.script) {
                 continue;
@@ -142,17 +153,20 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
                 continue;
             }
 
-            for(uint32_t i = 0; i < spawner_object.script->initial_spawn; i++) {
-                spdlog::trace("[{}] spawner_object {} has {} npc_ids", __FUNCTION__, spawner_object.name, spawner_object.script->npc_ids.size());
-                auto &random_npc_id = spawner_object.script->npc_ids[lotr::random.generate_single(0, spawner_object.script->npc_ids.size() - 1)];
+            // the map entity owns the script from here on
+            auto spawner = add_spawner(m, move(*spawner_object.script));
+            spawner_object.script.reset();
+            auto const &script = m.entities.get<spawner_script>(spawner);
 
-                auto npc = create_npc(random_npc_id, m, &spawner_object.script.value());
+            for(uint32_t i = 0; i < script.initial_spawn; i++) {
+                spdlog::trace("[{}] spawner_object {} has {} npc_ids", __FUNCTION__, spawner_object.name, script.npc_ids.size());
 
-                if(npc) {
-                    m.npcs.emplace_back(move(*npc));
+                if(spawn_random_npc(m, spawner)) {
                     entity_count++;
                 }
             }
+
+            schedule_respawn(m, spawner);
         }
     }
 
@@ -178,12 +192,14 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
                 continue;
             }
 
-            auto npc = create_npc(npc_object.script->npc_ids[0], m, &npc_object.script.value());
+            auto spawner = add_spawner(m, move(*npc_object.script));
+            npc_object.script.reset();
 
-            if(npc) {
-                m.npcs.emplace_back(move(*npc));
+            if(spawn_npc(m.entities.get<spawner_script>(spawner).npc_ids[0], m, spawner)) {
                 entity_count++;
             }
+
+            schedule_respawn(m, spawner);
         }
     }
 
@@ -195,3 +211,46 @@ void lotr::load_assets(entt::registry &registry, atomic<bool> const &quit) {
     spdlog::info("[{}] everything loaded in {:n} µs", __FUNCTION__, chrono::duration_cast<chrono::microseconds>(loading_end - items_loading_start).count());
 }
 
+
+void lotr::load_fov_tables(entt::registry &registry, atomic<bool> const &quit) {
+    auto loading_start = chrono::system_clock::now();
+    uint32_t loaded_count = 0;
+    uint32_t built_count = 0;
+    error_code ec;
+    filesystem::create_directories("assets/fov", ec);
+
+    if(ec) {
+        spdlog::warn("[{}] could not create assets/fov, fov tables will not be persisted: {}", __FUNCTION__, ec.message());
+    }
+
+    auto map_view = registry.view<map_component>();
+    for(auto m_entity : map_view) {
+        if(quit) {
+            return;
+        }
+
+        map_component &m = map_view.get(m_entity);
+        auto path = filesystem::path("assets/fov") / (m.name + ".fov");
+
+        {
+            ifstream in(path, ios::binary);
+            if(in && m.fov_cache.load(in, m)) {
+                loaded_count++;
+                continue;
+            }
+        }
+
+        m.fov_cache = fov_table::build(m);
+        built_count++;
+
+        ofstream out(path, ios::binary | ios::trunc);
+        m.fov_cache.save(out);
+
+        if(!out) {
+            spdlog::warn("[{}] could not persist fov table for map {} to {}", __FUNCTION__, m.name, path.string());
+        }
+    }
+
+    auto loading_end = chrono::system_clock::now();
+    spdlog::info("[{}] {:n} fov tables loaded and {:n} built in {:n} µs", __FUNCTION__, loaded_count, built_count, chrono::duration_cast<chrono::microseconds>(loading_end - loading_start).count());
+}
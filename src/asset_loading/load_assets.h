@@ -23,5 +23,8 @@
 using namespace std;
 
 namespace lotr {
-    void load_assets(entt::registry &registry, atomic<bool> const &quit);
+    // tick_length in ms, spawner respawn rates are converted to ticks with it
+    void load_assets(entt::registry &registry, uint32_t tick_length, atomic<bool> const &quit);
+    // loads persisted fov tables from assets/fov, (re)building and persisting them when missing or stale
+    void load_fov_tables(entt::registry &registry, atomic<bool> const &quit);
 }
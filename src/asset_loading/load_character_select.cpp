@@ -20,6 +20,7 @@
 #include <working_directory_manipulation.h>
 #include "spdlog/spdlog.h"
 #include <yaml-cpp/yaml.h>
+#include "load_stats.h"
 #include <ecs/components.h>
 
 using namespace std;
@@ -53,11 +54,9 @@ optional<character_select_response> lotr::load_character_select() {
     }
 
     vector<stat_component> base_stats;
-    for (auto const &stat : stat_names) {
-        if (tree["baseStats"][stat]) {
-            base_stats.emplace_back(stat, tree["baseStats"][stat].as<int32_t>());
-        }
-    }
+    for_each_stat_node(tree["baseStats"], [&base_stats](stat_id id, YAML::Node const &value) {
+        base_stats.emplace_back(string(stat_name_table[id]), value.as<int32_t>());
+    });
 
     emplace_maxhp_maxmp(base_stats);
 
@@ -73,11 +72,9 @@ optional<character_select_response> lotr::load_character_select() {
         vector<item_object> items;
         vector<skill_object> skills;
         if(allegiance_node["statMods"]) {
-            for (auto const &stat : stat_names) {
-                if (allegiance_node["statMods"][stat]) {
-                    stat_mods.emplace_back(stat, allegiance_node["statMods"][stat].as<int32_t>());
-                }
-            }
+            for_each_stat_node(allegiance_node["statMods"], [&stat_mods](stat_id id, YAML::Node const &value) {
+                stat_mods.emplace_back(string(stat_name_table[id]), value.as<int32_t>());
+            });
 
             if(allegiance_node["statMods"]["gold"]) {
                 stat_mods.emplace_back("gold", allegiance_node["statMods"]["gold"].as<int32_t>());
@@ -106,11 +103,9 @@ optional<character_select_response> lotr::load_character_select() {
         spdlog::trace("[{}] loading class {}", __FUNCTION__, class_node["name"].as<string>());
         vector<stat_component> stat_mods;
 
-        for (auto const &stat : stat_names) {
-            if (class_node["statMods"][stat]) {
-                stat_mods.emplace_back(stat, class_node["statMods"][stat].as<int32_t>());
-            }
-        }
+        for_each_stat_node(class_node["statMods"], [&stat_mods](stat_id id, YAML::Node const &value) {
+            stat_mods.emplace_back(string(stat_name_table[id]), value.as<int32_t>());
+        });
 
         if(class_node["statMods"]["gold"]) {
             stat_mods.emplace_back("gold", class_node["statMods"]["gold"].as<int32_t>());
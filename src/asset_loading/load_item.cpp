@@ -18,6 +18,7 @@
 
 #include "load_item.h"
 #include <yaml-cpp/yaml.h>
+#include "load_stats.h"
 #include <working_directory_manipulation.h>
 #include "spdlog/spdlog.h"
 
@@ -52,17 +53,15 @@ vector<global_item_component> lotr::load_global_items_from_file(string const &fi
 
         spdlog::debug("[{}] loading item {}", __FUNCTION__, item.name);
 
-        for (auto const &stat : stat_names) {
-            if (item_node["stats"] && item_node["stats"][stat]) {
-                spdlog::trace("[{}] loading stat {}:{}", __FUNCTION__, stat, item_node["stats"][stat].as<int64_t>());
-                item.stats.emplace_back(stat, item_node["stats"][stat].as<int64_t>());
-            }
+        for_each_stat_node(item_node["stats"], [&item](stat_id id, YAML::Node const &value) {
+            spdlog::trace("[{}] loading stat {}:{}", __FUNCTION__, stat_name_table[id], value.as<int64_t>());
+            item.stats.emplace_back(string(stat_name_table[id]), value.as<int64_t>());
+        });
 
-            if (item_node["randomStats"] && item_node["randomStats"][stat]) {
-                spdlog::trace("[{}] loading random stat {}:{}-{}", __FUNCTION__, stat, item_node["randomStats"][stat]["min"].as<int64_t>(), item_node["randomStats"][stat]["max"].as<int64_t>());
-                item.random_stats.emplace_back(stat, item_node["randomStats"][stat]["min"].as<int64_t>(), item_node["randomStats"][stat]["max"].as<int64_t>());
-            }
-        }
+        for_each_stat_node(item_node["randomStats"], [&item](stat_id id, YAML::Node const &range) {
+            spdlog::trace("[{}] loading random stat {}:{}-{}", __FUNCTION__, stat_name_table[id], range["min"].as<int64_t>(), range["max"].as<int64_t>());
+            item.random_stats.emplace_back(string(stat_name_table[id]), range["min"].as<int64_t>(), range["max"].as<int64_t>());
+        });
 
         ITEM_STRING_FIELD(type)
 
@@ -103,12 +102,10 @@ vector<global_item_component> lotr::load_global_items_from_file(string const &fi
             EFFECT_BOOL_FIELD(autocast)
             EFFECT_BOOL_FIELD(can_apply)
 
-            for (auto const &stat : stat_names) {
-                if (item_node["effect"]["stats"] && item_node["effect"]["stats"][stat]) {
-                    spdlog::trace("[{}] loading effect stat {}:{}", __FUNCTION__, stat, item_node["effect"]["stats"][stat].as<int64_t>());
-                    effect.stats.emplace_back(stat, item_node["effect"]["stats"][stat].as<int64_t>());
-                }
-            }
+            for_each_stat_node(item_node["effect"]["stats"], [&effect](stat_id id, YAML::Node const &value) {
+                spdlog::trace("[{}] loading effect stat {}:{}", __FUNCTION__, stat_name_table[id], value.as<int64_t>());
+                effect.stats.emplace_back(string(stat_name_table[id]), value.as<int64_t>());
+            });
 
             item.effect = effect;
         }
@@ -49,9 +49,9 @@ optional<spawner_script> create_spawner_script_for_npc(rapidjson::Value &current
 
     script.npc_ids.emplace_back(1, current_object["name"].GetString());
     script.npc_ids[0].sprite.push_back(current_object["gid"].GetUint() - first_gid);
-    script.npc_ids[0].stats.reserve(stat_names.size());
-    for(auto &stat : stat_names) {
-        script.npc_ids[0].stats.emplace_back(stat, 10);
+    script.npc_ids[0].stats.reserve(stat_name_table.size());
+    for(auto const &stat : stat_name_table) {
+        script.npc_ids[0].stats.emplace_back(string(stat), 10);
     }
 
     return script;
@@ -122,28 +122,12 @@ optional<spawner_script> get_spawner_script(string const &script_file, uint32_t
                 spdlog::error("[{}] npc file {} path {} split {} couldn't convert to integer", __FUNCTION__, actual_script_file, path, split);
                 continue;
             }
-            movement_direction dir;
-            if(temp[1] == north_direction) {
-                dir = movement_direction::North;
-            } else if(temp[1] == east_direction) {
-                dir = movement_direction::East;
-            } else if(temp[1] == south_direction) {
-                dir = movement_direction::South;
-            } else if(temp[1] == west_direction)  {
-                dir = movement_direction::West;
-            } else if(temp[1] == north_east_direction)  {
-                dir = movement_direction::NorthEast;
-            } else if(temp[1] == north_west_direction)  {
-                dir = movement_direction::NorthWest;
-            } else if(temp[1] == south_east_direction)  {
-                dir = movement_direction::SouthEast;
-            } else if(temp[1] == south_west_direction)  {
-                dir = movement_direction::SouthWest;
-            } else {
+            auto dir = direction_from_string(temp[1]);
+            if(!dir) {
                 spdlog::error("[{}] npc file {} could not decode path {} split {} missing direction {}", __FUNCTION__, actual_script_file, path, split, temp[1]);
                 continue;
             }
-            spawn_paths.emplace_back(dir, value);
+            spawn_paths.emplace_back(*dir, value);
         }
         script.paths.emplace_back(move(spawn_paths));
     }
@@ -265,17 +249,17 @@ optional<map_component> lotr::load_map_from_file(const string &file, entt::regis
 
         if(current_layer["type"].GetString() == "tilelayer"s) {
             vector<uint32_t> data;
+            data.reserve(current_layer["data"].Size());
             for (SizeType j = 0; j < current_layer["data"].Size(); j++) {
                 data.push_back(current_layer["data"][j].GetUint());
             }
             map_layers[current_layer_enum] = map_layer(current_layer["x"].GetInt(), current_layer["y"].GetInt(), current_layer["width"].GetInt(),
-                                                   current_layer["height"].GetInt(), current_layer_name, current_layer["type"].GetString(), vector<map_object>{}, data);
+                                                   current_layer["height"].GetInt(), current_layer_name, current_layer["type"].GetString(), sparse_layer<map_object>{}, data);
         }
 
 
         if(current_layer["type"].GetString() == "objectgroup"s) {
-            vector<map_object> objects;
-            objects.resize(width*height);
+            sparse_layer<map_object> objects(width, height);
 
             for (SizeType j = 0; j < current_layer["objects"].Size(); j++) {
                 auto& current_object = current_layer["objects"][j];
@@ -294,6 +278,11 @@ optional<map_component> lotr::load_map_from_file(const string &file, entt::regis
                 optional<spawner_script> spawn_script;
                 uint32_t x = current_object["x"].GetUint() / tilewidth;
                 uint32_t y = (current_object["y"].GetUint() - tileheight) / tileheight; // something weird about tiled putting an object at offset Y coords
+                if(x >= width || y >= height) {
+                    spdlog::error("[{}] object {} at {}:{} is outside of the map", __FUNCTION__, current_object["id"].GetUint(), x, y);
+                    continue;
+                }
+
                 auto object_script_property = find_if(begin(object_properties), end(object_properties), [](map_property const &prop) noexcept {return prop.name == "script";});
                 if(current_layer_enum == map_layer_name::Spawners && object_script_property != end(object_properties)) {
                     auto cache_it = spawner_script_cache.find(get<string>(object_script_property->value));
@@ -324,9 +313,10 @@ optional<map_component> lotr::load_map_from_file(const string &file, entt::regis
                     spdlog::trace("[{}] npc {} assigned spawner", __FUNCTION__, current_object["name"].GetString());
                 }
 
-                objects[x + y * width] = map_object(gid, current_object["id"].GetUint(), current_object["width"].GetUint(),
-                        current_object["height"].GetUint(), current_object["name"].GetString(), current_object["type"].GetString(), object_properties, spawn_script);
+                objects.insert(x + y * width, map_object(gid, current_object["id"].GetUint(), current_object["width"].GetUint(),
+                        current_object["height"].GetUint(), current_object["name"].GetString(), current_object["type"].GetString(), object_properties, spawn_script));
             }
+            objects.shrink_to_fit();
             spdlog::trace("[{}] layer width {} height {} object size {}", __FUNCTION__, width, height, objects.size());
             // for some reason, width/height are not present in the json files?
             map_layers[current_layer_enum] = map_layer(current_layer["x"].GetInt(), current_layer["y"].GetInt(), width, height, current_layer_name, current_layer["type"].GetString(), move(objects), vector<uint32_t>{});
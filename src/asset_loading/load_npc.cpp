@@ -18,13 +18,14 @@
 
 #include "load_npc.h"
 #include <yaml-cpp/yaml.h>
+#include "load_stats.h"
 #include <working_directory_manipulation.h>
 #include "spdlog/spdlog.h"
 
 using namespace std;
 using namespace lotr;
 
-#define NPC_STRING_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<string>(); }
+#define NPC_STRING_FIELD(x) if(npc_node[ #x ]) { npc. x = interned_string(npc_node[ #x ].as<string>()); }
 #define NPC_UINT_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<uint32_t>(); }
 #define NPC_BOOL_FIELD(x) if(npc_node[ #x ]) { npc. x = npc_node[ #x ].as<bool>(); }
 
@@ -46,10 +47,18 @@ vector<global_npc_component> lotr::load_global_npcs_from_file(string const &file
 
         spdlog::debug("[{}] loading npc {}", __FUNCTION__, npc.name);
 
-        npc.npc_id = npc_node["npcId"].as<string>();
+        npc.npc_id = interned_string(npc_node["npcId"].as<string>());
 
         NPC_STRING_FIELD(alignment)
-        NPC_STRING_FIELD(hostility)
+
+        if(npc_node["hostility"]) {
+            auto hostility = hostility_from_string(npc_node["hostility"].as<string>());
+            if(hostility) {
+                npc.hostility = *hostility;
+            } else {
+                spdlog::error("[{}] npc {} unknown hostility {}", __FUNCTION__, npc.name, npc_node["hostility"].as<string>());
+            }
+        }
 
         if(npc_node["sprite"].Type() == YAML::NodeType::Sequence) {
             for(auto const &sprite_node : npc_node["sprite"]) {
@@ -66,29 +75,27 @@ vector<global_npc_component> lotr::load_global_npcs_from_file(string const &file
         }
 
         if(npc_node["spawnMessage"]) {
-            npc.spawn_message = npc_node["spawnMessage"].as<string>();
+            npc.spawn_message = interned_string(npc_node["spawnMessage"].as<string>());
         }
 
         if(npc_node["sfx"]) {
-            npc.sfx = npc_node["sfx"].as<string>();
+            npc.sfx = interned_string(npc_node["sfx"].as<string>());
             npc.sfx_max_chance = npc_node["sfxMaxChance"].as<uint32_t>();
         }
 
         auto base_stat = npc_node["stats"].as<uint32_t >();
-        for (auto const &stat : stat_names) {
-            //spdlog::trace("[{}] loading stat {}", __FUNCTION__, stat);
-            npc.stats.emplace_back(stat, base_stat);
+        npc.stats.reserve(StatCount);
+        for (auto const &stat : stat_name_table) {
+            npc.stats.emplace_back(string(stat), base_stat);
+        }
 
-            if (npc_node["otherStats"] && npc_node["otherStats"][stat]) {
-                //spdlog::trace("[{}] loading stat {}:{}", __FUNCTION__, stat, npc_node["otherStats"][stat].as<int64_t>());
-                npc.stats.back().value = npc_node["otherStats"][stat].as<int64_t>();
-            }
+        for_each_stat_node(npc_node["otherStats"], [&npc](stat_id id, YAML::Node const &value) {
+            npc.stats[id].value = value.as<int64_t>();
+        });
 
-            if (npc_node[stat]) {
-                //spdlog::trace("[{}] loading random stat {}:{}-{}", __FUNCTION__, stat, npc_node[stat]["min"].as<int64_t>(), npc_node[stat]["max"].as<int64_t>());
-                npc.random_stats.emplace_back(stat, npc_node[stat]["min"].as<int64_t>(), npc_node[stat]["max"].as<int64_t>());
-            }
-        }
+        for_each_stat_node(npc_node, [&npc](stat_id id, YAML::Node const &range) {
+            npc.random_stats.emplace_back(string(stat_name_table[id]), range["min"].as<int64_t>(), range["max"].as<int64_t>());
+        });
 
         npc.random_stats.emplace_back("gold", npc_node["gold"]["min"].as<int64_t>(), npc_node["gold"]["max"].as<int64_t>());
         npc.random_stats.emplace_back("give_xp", npc_node["giveXp"]["min"].as<int64_t>(), npc_node["giveXp"]["max"].as<int64_t>());
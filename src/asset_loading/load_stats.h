@@ -0,0 +1,52 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <yaml-cpp/yaml.h>
+#include <ecs/stats.h>
+
+using namespace std;
+
+namespace lotr {
+    // Calls f(stat_id, value_node) for every key of stats_node that names a stat, in stat_id order.
+    // Walks the yaml map once and resolves keys with the perfect hash instead of doing a yaml lookup per stat name.
+    template <typename Func>
+    void for_each_stat_node(YAML::Node const &stats_node, Func &&f) {
+        if(!stats_node || !stats_node.IsMap()) {
+            return;
+        }
+
+        array<optional<YAML::Node>, StatCount> found;
+        for(auto const &entry : stats_node) {
+            auto const id = stat_id_from_name(entry.first.as<string>());
+            if(id) {
+                found[*id].emplace(entry.second);
+            }
+        }
+
+        for(uint32_t i = 0; i < StatCount; i++) {
+            if(found[i]) {
+                f(static_cast<stat_id>(i), *found[i]);
+            }
+        }
+    }
+}
@@ -29,6 +29,19 @@ namespace lotr {
         string debug_level;
         string connection_string;
         uint32_t tick_length;
+        uint32_t tick_budget_percent;
+        uint32_t tick_spin_us;
+        int32_t game_thread_cpu;
+        int32_t io_thread_cpu;
+        uint32_t tick_threads;
+        uint32_t sender_threads;
+        uint32_t max_pending_per_connection;
+        uint64_t max_send_buffer_bytes;
+        uint32_t tick_profile_interval;
+        uint32_t map_keyframe_interval;
+        uint32_t ai_full_radius;
+        uint32_t dormant_map_interval;
+        bool precompute_fov;
         bool log_tick_times;
         bool use_ssl;
     };
@@ -86,5 +86,83 @@ optional<config> lotr::parse_env_file() {
     config.log_tick_times = d["LOG_TICK_TIMES"].GetBool();
     config.use_ssl = d["USE_SSL"].GetBool();
 
+    // optional, percentage of TICK_LENGTH after which respawns and npc ai are left for the next tick. 0 never defers them.
+    config.tick_budget_percent = 80;
+    if(d.HasMember("TICK_BUDGET_PERCENT")) {
+        config.tick_budget_percent = d["TICK_BUDGET_PERCENT"].GetUint();
+    }
+
+    // optional, the game loop sleeps until this many µs before a tick is due and busy waits the rest, for a steadier tick rate
+    config.tick_spin_us = 300;
+    if(d.HasMember("TICK_SPIN_US")) {
+        config.tick_spin_us = d["TICK_SPIN_US"].GetUint();
+    }
+
+    // optional, cpus to pin the game loop and the websocket/database thread to. -1 leaves them to the OS.
+    config.game_thread_cpu = -1;
+    if(d.HasMember("GAME_THREAD_CPU")) {
+        config.game_thread_cpu = d["GAME_THREAD_CPU"].GetInt();
+    }
+
+    config.io_thread_cpu = -1;
+    if(d.HasMember("IO_THREAD_CPU")) {
+        config.io_thread_cpu = d["IO_THREAD_CPU"].GetInt();
+    }
+
+    // optional, amount of threads the maps are ticked on. 0 or 1 ticks everything on the game loop thread.
+    config.tick_threads = 1;
+    if(d.HasMember("TICK_THREADS")) {
+        config.tick_threads = d["TICK_THREADS"].GetUint();
+    }
+
+    // optional, amount of threads serializing and sending outward messages
+    config.sender_threads = 1;
+    if(d.HasMember("SENDER_THREADS")) {
+        config.sender_threads = d["SENDER_THREADS"].GetUint();
+    }
+
+    // optional, outward messages a connection can have waiting for a sender thread before it is disconnected.
+    // This only fills up when the sender threads fall behind, slow clients are caught by MAX_SEND_BUFFER_BYTES.
+    config.max_pending_per_connection = 4096;
+    if(d.HasMember("MAX_PENDING_PER_CONNECTION")) {
+        config.max_pending_per_connection = d["MAX_PENDING_PER_CONNECTION"].GetUint();
+    }
+
+    // optional, bytes a connection can have sent but not yet written to its socket before it is disconnected
+    config.max_send_buffer_bytes = 4 * 1024 * 1024;
+    if(d.HasMember("MAX_SEND_BUFFER_BYTES")) {
+        config.max_send_buffer_bytes = d["MAX_SEND_BUFFER_BYTES"].GetUint64();
+    }
+
+    // optional, seconds between publishing tick percentiles when LOG_TICK_TIMES is set
+    config.tick_profile_interval = 10;
+    if(d.HasMember("TICK_PROFILE_INTERVAL")) {
+        config.tick_profile_interval = d["TICK_PROFILE_INTERVAL"].GetUint();
+    }
+
+    // optional, ticks between full map updates, deltas are sent in between. 0 or 1 always sends full updates.
+    config.map_keyframe_interval = 100;
+    if(d.HasMember("MAP_KEYFRAME_INTERVAL")) {
+        config.map_keyframe_interval = d["MAP_KEYFRAME_INTERVAL"].GetUint();
+    }
+
+    // optional, npcs further than this many tiles from any player only do a cheap update instead of their full ai
+    config.ai_full_radius = 12;
+    if(d.HasMember("AI_FULL_RADIUS")) {
+        config.ai_full_radius = d["AI_FULL_RADIUS"].GetUint();
+    }
+
+    // optional, maps without players only run timers, spawners and ai every this many ticks. 0 or 1 ticks them like any other map.
+    config.dormant_map_interval = 10;
+    if(d.HasMember("DORMANT_MAP_INTERVAL")) {
+        config.dormant_map_interval = d["DORMANT_MAP_INTERVAL"].GetUint();
+    }
+
+    // optional, precompute fov for every tile at load instead of every tick. Tables are cached in assets/fov.
+    config.precompute_fov = false;
+    if(d.HasMember("PRECOMPUTE_FOV")) {
+        config.precompute_fov = d["PRECOMPUTE_FOV"].GetBool();
+    }
+
     return config;
 }
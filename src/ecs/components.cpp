@@ -69,7 +69,7 @@ namespace  lotr {
     string const stat_action_speed = "actionSpeed";
     /*, "damageFactor"s TODO damage factor is a double :< */
 
-    string const hostility_never = "always";
+    string const hostility_never = "never";
     string const hostility_on_hit = "onHit";
     string const hostility_faction = "faction";
     string const hostility_always = "always";
@@ -89,25 +89,24 @@ namespace  lotr {
     extern string const gear_slot_feet = "feet";
     extern string const gear_slot_ear = "ear";
 
-    array<string const, 40> const stat_names = {stat_str, stat_dex, stat_agi, stat_int, stat_wis, stat_wil, stat_luk, stat_cha, stat_con, stat_move,
-                                                stat_hpregen, stat_mpregen, stat_hp, stat_mp, stat_max_hp, stat_max_mp, stat_hweapon_damage_rolls, stat_weapon_armor_class, stat_armor_class,
-                                                stat_accuracy, stat_offense, stat_defense, stat_stealth, stat_perception, stat_physical_damage_boost, stat_magical_damage_boost,
-                                                stat_healing_boost, stat_physical_damage_reflect, stat_magical_damage_reflect, stat_mitigation, stat_magical_resist,
-                                                stat_physical_resist, stat_necrotic_resist, stat_energy_resist, stat_water_resist, stat_fire_resist, stat_ice_resist,
-                                                stat_poison_resist, stat_disease_resist, stat_action_speed };
-
     array<string const, 14> const slot_names = {gear_slot_right_hand, gear_slot_left_hand, gear_slot_armor, gear_slot_robe1, gear_slot_robe2, gear_slot_ring1,
                                                 gear_slot_ring2, gear_slot_head, gear_slot_next, gear_slot_waist, gear_slot_wrist, gear_slot_hands,
                                                 gear_slot_feet, gear_slot_ear};
 
 
     global_npc_component* get_global_npc_by_npc_id(entt::registry &registry, string const &npc_id) {
+        auto id = interned_string::find(npc_id);
+
+        if(!id) {
+            return nullptr;
+        }
+
         auto gnpc_view = registry.view<global_npc_component>();
 
         for(auto gnpc_entity : gnpc_view) {
             global_npc_component &gnpc = gnpc_view.get(gnpc_entity);
 
-            if(gnpc.npc_id != npc_id) {
+            if(gnpc.npc_id != *id) {
                 continue;
             }
 
@@ -117,6 +116,42 @@ namespace  lotr {
         return nullptr;
     }
 
+    optional<npc_hostility> hostility_from_string(string_view s) noexcept {
+        if(s == hostility_never) {
+            return HostilityNever;
+        } else if(s == hostility_on_hit) {
+            return HostilityOnHit;
+        } else if(s == hostility_faction) {
+            return HostilityFaction;
+        } else if(s == hostility_always) {
+            return HostilityAlways;
+        }
+
+        return {};
+    }
+
+    optional<movement_direction> direction_from_string(string_view s) noexcept {
+        if(s == north_direction) {
+            return North;
+        } else if(s == east_direction) {
+            return East;
+        } else if(s == south_direction) {
+            return South;
+        } else if(s == west_direction) {
+            return West;
+        } else if(s == north_east_direction) {
+            return NorthEast;
+        } else if(s == north_west_direction) {
+            return NorthWest;
+        } else if(s == south_east_direction) {
+            return SouthEast;
+        } else if(s == south_west_direction) {
+            return SouthWest;
+        }
+
+        return {};
+    }
+
     map_component* get_map_by_name(entt::registry &registry, string const &name) {
         auto map_view = registry.view<map_component>();
 
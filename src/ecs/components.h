@@ -24,14 +24,21 @@
 #include <vector>
 #include <optional>
 #include <lotr_flat_map.h>
+#include <ecs/stats.h>
+#include <ecs/interned_string.h>
 #include <game_logic/fov.h>
 #include <entt/entity/registry.hpp>
 #include <game_logic/location.h>
+#include <game_logic/spatial_grid.h>
+#include <game_logic/fov_table.h>
+#include <game_logic/timer_wheel.h>
+#include <game_logic/tile_bitplanes.h>
+#include <game_logic/sparse_layer.h>
+#include <game_logic/tile_layer.h>
 
 using namespace std;
 
 namespace lotr {
-    extern array<string const, 40> const stat_names;
     extern array<string const, 14> const slot_names;
 
     // enums
@@ -47,6 +54,13 @@ namespace lotr {
         SouthWest
     };
 
+    enum npc_hostility : uint8_t {
+        HostilityNever,
+        HostilityOnHit,
+        HostilityFaction,
+        HostilityAlways
+    };
+
     enum map_layer_name : uint32_t {
         Terrain = 0,
         Floors,
@@ -145,16 +159,16 @@ namespace lotr {
 
     struct global_npc_component {
         string name;
-        string npc_id;
-        string allegiance;
-        string alignment;
-        string gender;
-        string dir;
-        string hostility;
-        string character_class;
-        string monster_class;
-        string spawn_message;
-        string sfx;
+        interned_string npc_id;
+        interned_string allegiance;
+        interned_string alignment;
+        interned_string gender;
+        movement_direction dir = South;
+        npc_hostility hostility = HostilityAlways;
+        interned_string character_class;
+        interned_string monster_class;
+        interned_string spawn_message;
+        interned_string sfx;
 
         uint32_t level;
         uint32_t highest_level;
@@ -171,16 +185,16 @@ namespace lotr {
 
     struct spawner_npc_id {
         uint32_t chance;
-        string npc_id;
-        string allegiance;
-        string alignment;
-        string gender;
-        string dir;
-        string hostility;
-        string character_class;
-        string monster_class;
-        string spawn_message;
-        string sfx;
+        interned_string npc_id;
+        interned_string allegiance;
+        interned_string alignment;
+        interned_string gender;
+        movement_direction dir;
+        npc_hostility hostility;
+        interned_string character_class;
+        interned_string monster_class;
+        interned_string spawn_message;
+        interned_string sfx;
 
         uint32_t level;
         uint32_t highest_level;
@@ -193,7 +207,8 @@ namespace lotr {
         vector<item_component> items;
         vector<skill_component> skills;
 
-        spawner_npc_id(uint32_t chance, string npc_id) : chance(chance), npc_id(move(npc_id)) {}
+        spawner_npc_id(uint32_t chance, string_view npc_id) : chance(chance), npc_id(npc_id), allegiance(), alignment(), gender(), dir(South), hostility(HostilityAlways), character_class(),
+        monster_class(), spawn_message(), sfx(), level(), highest_level(), sprite(), skill_on_kill(), sfx_max_chance(), stats(), random_stats(), items(), skills() {}
         spawner_npc_id(uint32_t chance, global_npc_component const &npc)
         : chance(chance), npc_id(npc.npc_id), allegiance(npc.allegiance), alignment(npc.alignment), gender(npc.gender), dir(npc.dir), hostility(npc.hostility),
         character_class(npc.character_class), monster_class(npc.monster_class), spawn_message(npc.spawn_message), sfx(npc.sfx), level(npc.level), highest_level(npc.highest_level),
@@ -242,61 +257,133 @@ namespace lotr {
         silver_purchases_component() : name(), count(0) {}
     };
 
-    struct character_component {
+    // Live npcs and players are entities in the entities registry of their map. What the tick reads every time is split
+    // into small components, so systems stream over packed arrays. pc_component and npc_component hold the rest.
+
+    struct position_component {
+        location loc;
+
+        position_component(location loc) noexcept : loc(loc) {}
+    };
+
+    // current values, stats only hold the values an entity was created with
+    struct vitals_component {
+        int64_t hp;
+        int64_t max_hp;
+        int64_t mp;
+        int64_t max_mp;
+
+        vitals_component() noexcept : hp(), max_hp(), mp(), max_mp() {}
+        vitals_component(int64_t hp, int64_t max_hp, int64_t mp, int64_t max_mp) noexcept : hp(hp), max_hp(max_hp), mp(mp), max_mp(max_mp) {}
+    };
+
+    // what clients get to see of an entity, id is what they key map updates on
+    struct appearance_component {
         uint64_t id;
         string name;
-        string allegiance;
-        string alignment;
-        string gender;
-        string dir;
-        string hostility;
-        string character_class;
-        string monster_class;
-        string spawn_message;
-        string sfx;
+        uint32_t sprite;
+        movement_direction dir;
+
+        appearance_component(uint64_t id, string name, uint32_t sprite) : id(id), name(move(name)), sprite(sprite), dir(South) {}
+    };
+
+    struct ai_component {
+        npc_hostility hostility;
+        // entity on the same map, check with entities.valid() before use as it may have died or left since
+        entt::entity agro_target;
+        vector<npc_path> paths;
+        uint32_t current_path_index;
+        uint64_t steps_remaining_in_path;
+
+        location loc_before_interruption;
+        bool is_path_interrupted;
+        // no player was within ai_full_radius on the last action, so only the coarse update ran
+        bool coarse;
+        // AiTimer fired and the npc waits in map_component::pending_ai, it gets rescheduled once that runs
+        bool pending;
+
+        ai_component() : hostility(HostilityAlways), agro_target(entt::null), paths(), current_path_index(0), steps_remaining_in_path(0), loc_before_interruption(0, 0),
+            is_path_interrupted(), coarse(), pending() {}
+    };
+
+    // the entity of the spawner_script on the same map, may be null or refer to a spawner that no longer exists
+    struct spawner_link_component {
+        entt::entity spawner;
+
+        spawner_link_component(entt::entity spawner) noexcept : spawner(spawner) {}
+    };
+
+    // runtime side of a spawner_script, see spawners.h
+    struct spawner_state_component {
+        uint32_t alive;
+        // lifetime total, checked against max_spawn
+        uint32_t spawned;
+        uint64_t respawn_ticks;
+        uint64_t next_respawn_tick;
+        // walkable tiles within spawn_radius, or just the spawner location
+        vector<location> spawn_tiles;
+
+        spawner_state_component() : alive(0), spawned(0), respawn_ticks(1), next_respawn_tick(0), spawn_tiles() {}
+    };
+
+    // what a connection was last told about an entity it can see
+    struct sent_entity_state {
+        string name;
+        uint32_t sprite;
+        location loc;
+        uint32_t seen_tick;
+
+        sent_entity_state(string name, uint32_t sprite, location loc, uint32_t seen_tick) : name(move(name)), sprite(sprite), loc(loc), seen_tick(seen_tick) {}
+    };
+
+    struct connection_component {
+        uint64_t connection_id;
+        bitset<power(fov_diameter)> fov;
+
+        // map update delta state, keyed by entity id
+        lotr_flat_map<uint64_t, sent_entity_state> sent_entities;
+        uint32_t update_tick;
+        uint32_t ticks_since_keyframe;
+        bool keyframe_requested;
+
+        connection_component(uint64_t connection_id) : connection_id(connection_id), fov(), sent_entities(), update_tick(), ticks_since_keyframe(), keyframe_requested(true) {}
+    };
+
+    struct character_component {
+        interned_string allegiance;
+        interned_string alignment;
+        interned_string gender;
+        interned_string character_class;
+        interned_string monster_class;
+        interned_string spawn_message;
+        interned_string sfx;
 
         uint32_t level;
         uint32_t highest_level;
-        uint32_t sprite;
         uint32_t skill_on_kill;
         uint32_t gold;
         uint32_t give_xp;
         uint32_t sfx_max_chance;
 
-        location loc;
-
-        lotr_flat_map<string, uint64_t> stats;
+        stat_array stats;
         lotr_flat_map<string, item_component> items;
         vector<skill_component> skills;
         //location_component location;
 
-        character_component() : id(), name(), allegiance(), alignment(), gender(), dir(), hostility(), character_class(), monster_class(), spawn_message(),
-                          sfx(), level(), highest_level(), sprite(), skill_on_kill(), sfx_max_chance(), loc(), stats(), items(), skills() {}
+        character_component() : allegiance(), alignment(), gender(), character_class(), monster_class(), spawn_message(), sfx(), level(), highest_level(),
+                          skill_on_kill(), gold(), give_xp(), sfx_max_chance(), stats(), items(), skills() {}
     };
 
     struct pc_component : character_component {
         vector<silver_purchases_component> silver_purchases;
-        bitset<power(fov_diameter)> fov;
-        uint64_t connection_id;
 
-        pc_component() : character_component(), silver_purchases(), fov() {}
+        pc_component() : character_component(), silver_purchases() {}
     };
 
     struct npc_component : character_component {
-        string npc_id;
-
-        spawner_script *spawner;
-        npc_component *agro_target;
-        vector<npc_path> paths;
-        uint32_t current_path_index;
-        uint64_t steps_remaining_in_path;
-
-        location loc_before_interruption;
-        bool is_path_interrupted;
+        interned_string npc_id;
 
-
-        npc_component() : character_component(), npc_id(), spawner(nullptr), agro_target(nullptr), paths(), current_path_index(0),
-            steps_remaining_in_path(0), loc_before_interruption(0, 0), is_path_interrupted() {}
+        npc_component() : character_component(), npc_id() {}
     };
 
     struct user_component {
@@ -343,12 +430,24 @@ namespace lotr {
         string name;
         string type;
 
-        vector<map_object> objects;
-        vector<uint32_t> data;
+        // objectgroup layers only store the tiles that have an object
+        sparse_layer<map_object> objects;
+        // tilelayer gids, read through the accessor
+        tile_layer data;
 
         map_layer() : x(0), y(0), width(0), height(0), name(), type(), objects(), data() {}
-        map_layer(uint32_t x, uint32_t y, uint32_t width, uint32_t height, string name, string type, vector<map_object> objects, vector<uint32_t> data)
-            : x(x), y(y), width(width), height(height), name(move(name)), type(move(type)), objects(move(objects)), data(move(data)) {}
+        map_layer(uint32_t x, uint32_t y, uint32_t width, uint32_t height, string name, string type, sparse_layer<map_object> objects, vector<uint32_t> const &data)
+            : x(x), y(y), width(width), height(height), name(move(name)), type(move(type)), objects(move(objects)), data(data) {}
+
+        // from one object per tile, skipping default constructed objects
+        map_layer(uint32_t x, uint32_t y, uint32_t width, uint32_t height, string name, string type, vector<map_object> dense_objects, vector<uint32_t> const &data)
+            : x(x), y(y), width(width), height(height), name(move(name)), type(move(type)), objects(width, height), data(data) {
+            for(uint32_t i = 0; i < dense_objects.size() && i < objects.tile_count(); i++) {
+                if(dense_objects[i].gid != 0 || dense_objects[i].id != 0) {
+                    objects.insert(i, move(dense_objects[i]));
+                }
+            }
+        }
     };
 
     struct map_tileset {
@@ -365,11 +464,47 @@ namespace lotr {
         vector<map_property> properties;
         array<map_layer, 15> layers;
         vector<map_tileset> tilesets;
-        vector<npc_component> npcs;
-        vector<pc_component> players;
+        // derived from layers, rebuild when changing the walls or opaque decor layers
+        tile_bitplanes tiles;
+        // npcs, players and spawners living on this map, see the npc_group and players helpers in logic_helpers.h.
+        // Entities are recycled with a new version, so a stored entt::entity doubles as a generation checked handle.
+        entt::registry entities;
+        // use the add/remove/move helpers from logic_helpers.h to keep these in sync with the positions
+        spatial_grid npc_grid;
+        spatial_grid player_grid;
+        // connection id -> player entity
+        lotr_flat_map<uint64_t, entt::entity> player_connections;
+        // empty unless PRECOMPUTE_FOV is enabled
+        fov_table fov_cache;
+        // number of ticks this map has run, advanced at the start of tick_map
+        uint64_t tick;
+        // in ms, converts spawner respawn rates to ticks
+        uint32_t tick_length;
+        // npcs further than this from any player only get the coarse ai update
+        uint32_t ai_full_radius;
+        // maps without players only run their timers every this many ticks, 0 or 1 runs them every tick
+        uint32_t dormant_interval;
+        // timed work for the entities on this map, fired by run_timers in map_tick.h
+        timer_wheel timers;
+        // entities whose timer fired but whose work has not run yet, oldest first. Carried over to the next tick when a tick runs out of budget.
+        vector<entt::entity> pending_respawns;
+        vector<entt::entity> pending_ai;
+        // amount of pending work carried over to a next tick since the last publish of the tick profiler
+        uint64_t deferred_work;
 
         map_component(uint32_t width, uint32_t height, string name, vector<map_property> properties, array<map_layer, 15> layers, vector<map_tileset> tilesets)
-            : width(width), height(height), name(move(name)), properties(move(properties)), layers(move(layers)), tilesets(move(tilesets)), npcs(), players() {}
+            : width(width), height(height), name(move(name)), properties(move(properties)), layers(move(layers)), tilesets(move(tilesets)),
+            tiles(width, height, this->layers[map_layer_name::Walls], this->layers[map_layer_name::OpaqueDecor]), entities(),
+            npc_grid(width, height), player_grid(width, height), player_connections(), fov_cache(), tick(0), tick_length(1'000), ai_full_radius(12), dormant_interval(10), timers(),
+            pending_respawns(), pending_ai(), deferred_work(0) {}
+    };
+
+    // Game wide lookup of players, stored in the registry context. Maintained by the player enter and leave handlers.
+    struct player_index_component {
+        lotr_flat_map<uint64_t, entt::entity> map_by_connection;
+        lotr_flat_map<string, uint64_t> connection_by_name;
+
+        player_index_component() : map_by_connection(), connection_by_name() {}
     };
 
     // helper functions
@@ -434,6 +569,9 @@ namespace lotr {
     extern string const hostility_faction;
     extern string const hostility_always;
 
+    [[nodiscard]] optional<npc_hostility> hostility_from_string(string_view s) noexcept;
+    [[nodiscard]] optional<movement_direction> direction_from_string(string_view s) noexcept;
+
     extern string const gear_slot_right_hand;
     extern string const gear_slot_left_hand;
     extern string const gear_slot_armor;
@@ -0,0 +1,89 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "interned_string.h"
+
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <lotr_flat_map.h>
+
+using namespace std;
+using namespace lotr;
+
+namespace {
+    // deque so references returned by str() stay valid while new strings are added
+    struct interner {
+        shared_mutex mutex;
+        deque<string> strings;
+        lotr_flat_map<string, uint32_t> ids;
+
+        interner() : mutex(), strings(), ids() {
+            strings.emplace_back();
+            ids.emplace(string(), 0);
+        }
+    };
+
+    interner& get_interner() {
+        static interner instance;
+        return instance;
+    }
+}
+
+interned_string::interned_string(string_view s) : _id(0) {
+    if(s.empty()) {
+        return;
+    }
+
+    auto &in = get_interner();
+    string key(s);
+
+    {
+        shared_lock lock(in.mutex);
+        auto it = in.ids.find(key);
+        if(it != end(in.ids)) {
+            _id = it->second;
+            return;
+        }
+    }
+
+    unique_lock lock(in.mutex);
+    auto [it, inserted] = in.ids.emplace(key, static_cast<uint32_t>(in.strings.size()));
+    if(inserted) {
+        in.strings.emplace_back(move(key));
+    }
+    _id = it->second;
+}
+
+optional<interned_string> interned_string::find(string_view s) {
+    auto &in = get_interner();
+    shared_lock lock(in.mutex);
+    auto it = in.ids.find(string(s));
+
+    if(it == end(in.ids)) {
+        return {};
+    }
+
+    return interned_string(it->second);
+}
+
+string const & interned_string::str() const {
+    auto &in = get_interner();
+    shared_lock lock(in.mutex);
+    return in.strings[_id];
+}
@@ -0,0 +1,51 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+using namespace std;
+
+namespace lotr {
+    // 32-bit handle to a string stored once in a global table, for identifiers that are compared far more often than they are read.
+    // Id 0 is always the empty string, so default constructed and value initialized handles are empty.
+    class interned_string {
+    public:
+        interned_string() noexcept : _id(0) {}
+        explicit interned_string(string_view s);
+
+        // lookup without adding, for comparing against strings that may have never been interned
+        [[nodiscard]] static optional<interned_string> find(string_view s);
+
+        [[nodiscard]] string const & str() const;
+        [[nodiscard]] uint32_t id() const noexcept { return _id; }
+        [[nodiscard]] bool empty() const noexcept { return _id == 0; }
+
+        bool operator==(interned_string const &other) const noexcept { return _id == other._id; }
+        bool operator!=(interned_string const &other) const noexcept { return _id != other._id; }
+
+    private:
+        explicit interned_string(uint32_t id) noexcept : _id(id) {}
+
+        uint32_t _id;
+    };
+}
@@ -0,0 +1,150 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <string_view>
+#include <optional>
+#include <cstdint>
+
+using namespace std;
+
+namespace lotr {
+    // same order as stat_name_table
+    enum stat_id : uint8_t {
+        StatStr = 0,
+        StatDex,
+        StatAgi,
+        StatInt,
+        StatWis,
+        StatWil,
+        StatLuk,
+        StatCha,
+        StatCon,
+        StatMove,
+        StatHpRegen,
+        StatMpRegen,
+        StatHp,
+        StatMp,
+        StatMaxHp,
+        StatMaxMp,
+        StatWeaponDamageRolls,
+        StatWeaponArmorClass,
+        StatArmorClass,
+        StatAccuracy,
+        StatOffense,
+        StatDefense,
+        StatStealth,
+        StatPerception,
+        StatPhysicalDamageBoost,
+        StatMagicalDamageBoost,
+        StatHealingBoost,
+        StatPhysicalDamageReflect,
+        StatMagicalDamageReflect,
+        StatMitigation,
+        StatMagicalResist,
+        StatPhysicalResist,
+        StatNecroticResist,
+        StatEnergyResist,
+        StatWaterResist,
+        StatFireResist,
+        StatIceResist,
+        StatPoisonResist,
+        StatDiseaseResist,
+        StatActionSpeed,
+        StatCount
+    };
+
+    constexpr array<string_view, StatCount> stat_name_table = {"str", "dex", "agi", "int", "wis", "wil", "luk", "cha", "con", "move",
+                                                               "hpregen", "mpregen", "hp", "mp", "maxhp", "maxmp", "weaponDamageRolls", "weaponArmorClass", "armorClass",
+                                                               "accuracy", "offense", "defense", "stealth", "perception", "physicalDamageBoost", "magicalDamageBoost",
+                                                               "healingBoost", "physicalDamageReflect", "magicalDamageReflect", "mitigation", "magicalResist",
+                                                               "physicalResist", "necroticResist", "energyResist", "waterResist", "fireResist", "iceResist",
+                                                               "poisonResist", "diseaseResist", "actionSpeed"};
+
+    // stats of a character, indexed by stat_id
+    using stat_array = array<int64_t, StatCount>;
+
+    namespace detail {
+        constexpr uint32_t stat_hash_slots = 128;
+
+        constexpr uint32_t stat_hash(string_view name, uint32_t seed) noexcept {
+            // fnv-1a with a murmur3 finalizer, so the seed reaches the low bits
+            uint32_t hash = 2166136261U;
+            for(auto c : name) {
+                hash = (hash ^ static_cast<uint8_t>(c)) * 16777619U;
+            }
+            hash ^= seed * 0x9E3779B9U;
+            hash ^= hash >> 16;
+            hash *= 0x85EBCA6BU;
+            hash ^= hash >> 13;
+            hash *= 0xC2B2AE35U;
+            hash ^= hash >> 16;
+            return hash & (stat_hash_slots - 1);
+        }
+
+        // first seed for which every stat name gets its own slot
+        constexpr uint32_t find_stat_hash_seed() noexcept {
+            for(uint32_t seed = 0;; seed++) {
+                array<bool, stat_hash_slots> used{};
+                bool collision = false;
+                for(auto const &name : stat_name_table) {
+                    auto slot = stat_hash(name, seed);
+                    if(used[slot]) {
+                        collision = true;
+                        break;
+                    }
+                    used[slot] = true;
+                }
+
+                if(!collision) {
+                    return seed;
+                }
+            }
+        }
+
+        constexpr uint32_t stat_hash_seed = find_stat_hash_seed();
+
+        constexpr array<uint8_t, stat_hash_slots> build_stat_hash_table() noexcept {
+            array<uint8_t, stat_hash_slots> table{};
+            for(auto &slot : table) {
+                slot = StatCount;
+            }
+            for(uint32_t i = 0; i < StatCount; i++) {
+                table[stat_hash(stat_name_table[i], stat_hash_seed)] = i;
+            }
+            return table;
+        }
+
+        constexpr array<uint8_t, stat_hash_slots> stat_hash_table = build_stat_hash_table();
+    }
+
+    // perfect hash lookup, one hash and one string compare
+    constexpr optional<stat_id> stat_id_from_name(string_view name) noexcept {
+        auto const id = detail::stat_hash_table[detail::stat_hash(name, detail::stat_hash_seed)];
+        if(id == StatCount || stat_name_table[id] != name) {
+            return nullopt;
+        }
+        return static_cast<stat_id>(id);
+    }
+
+    static_assert(stat_id_from_name("str") == StatStr);
+    static_assert(stat_id_from_name("actionSpeed") == StatActionSpeed);
+    static_assert(!stat_id_from_name("gold"));
+}
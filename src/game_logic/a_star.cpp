@@ -63,15 +63,14 @@ array<location, 9> get_neighbours(map_component const &m, location const &loc) {
     array<location, 9> locs{location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}, location{-1, -1}};
     uint32_t counter = 0;
 
-    for(int32_t x = max(get<0>(loc) - 1, 0); x <= min(get<0>(loc) + 1, static_cast<int32_t >(m.width)); x++) {
-        for(int32_t y = max(get<1>(loc) - 1, 0); y <= min(get<1>(loc) + 1, static_cast<int32_t >(m.height)); y++) {
+    auto const mask = m.tiles.walkable_neighbours(get<0>(loc), get<1>(loc));
+    for(uint32_t i = 0; i < neighbour_offsets.size(); i++) {
+        if(mask & (1U << i)) {
+            locs[counter] = make_tuple(get<0>(loc) + get<0>(neighbour_offsets[i]), get<1>(loc) + get<1>(neighbour_offsets[i]));
 #ifdef EXTREME_A_STAR_LOGGING
-            spdlog::warn("[{}] {}:{}", __FUNCTION__, x, y);
+            spdlog::warn("[{}] {}:{}", __FUNCTION__, get<0>(locs[counter]), get<1>(locs[counter]));
 #endif
-            if(tile_is_walkable(m, x, y)) {
-                locs[counter] = make_tuple(x, y);
-                counter++;
-            }
+            counter++;
         }
     }
 
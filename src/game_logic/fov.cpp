@@ -39,7 +39,6 @@
 #include <algorithm>
 #include <bitset>
 #include <ecs/components.h>
-#include <memory>
 #include <spdlog/spdlog.h>
 
 //#define LOG_FOV_EXTREME 1
@@ -47,15 +46,9 @@
 using namespace std;
 using namespace lotr;
 
-/* angle ranges */
-unique_ptr<double[]> start_angle = nullptr;
-unique_ptr<double[]> end_angle = nullptr;
-/* number of allocated angle pairs */
-int allocated = 0;
-
 [[nodiscard]]
-bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_component const &m, map_layer const *walls_layer, map_layer const *opaque_layer,
-                                                                            int32_t const player_x, int32_t const player_y, bool const light_walls, int const dx, int const dy) {
+bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_component const &m, tile_bitplanes const &tiles, int32_t const player_x, int32_t const player_y,
+                                                                            bool const light_walls, int const dx, int const dy, fov_scratch &scratch) {
     bitset<power(fov_diameter)> fov_array{};
 
     // players location is always visible
@@ -67,7 +60,7 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
         bool done = false;
         int32_t total_obstacles = 0;
         int32_t obstacles_in_last_line = 0;
-        double min_angle = 0.0;
+        int32_t min_angle = 0;
         int32_t x;
         int32_t y;
 
@@ -79,9 +72,9 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
         }
         while (!done) {
             /* process cells in the line */
-            double slopes_per_cell = 1.0 / (double)(iteration);
-            double half_slopes = slopes_per_cell * 0.5;
-            int32_t processed_cell = static_cast<int32_t>((min_angle + half_slopes) / slopes_per_cell);
+            int32_t slopes_per_cell = fov_slope_scale / iteration;
+            int32_t half_slopes = slopes_per_cell / 2;
+            int32_t processed_cell = (min_angle + half_slopes) / slopes_per_cell;
             int32_t minx = max(0, player_x - iteration);
             int32_t maxx = min(static_cast<int32_t>(m.width) - 1, player_x + iteration);
             done = true;
@@ -92,33 +85,33 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
                 /* calculate slopes per cell */
                 bool visible = true;
                 bool extended = false;
-                double centre_slope = (double)processed_cell * slopes_per_cell;
-                double start_slope = centre_slope - half_slopes;
-                double end_slope = centre_slope + half_slopes;
-                auto const &object = opaque_layer->objects[c];
+                int32_t centre_slope = processed_cell * slopes_per_cell;
+                int32_t start_slope = centre_slope - half_slopes;
+                int32_t end_slope = centre_slope + half_slopes;
+                bool const opaque = tiles.opaque(static_cast<uint32_t>(c));
 
 #ifdef LOG_FOV_EXTREME
-                spdlog::trace("[{}] vertical {}:{} c {} wall {}", __FUNCTION__, x, y, c, walls_layer->data[c]);
+                spdlog::trace("[{}] vertical {}:{} c {} opaque {}", __FUNCTION__, x, y, c, opaque);
 #endif
 
                 if (obstacles_in_last_line > 0) {
-                    if (!(fov_array[c_fov - (fov_diameter * dy)] && walls_layer->data[c-(m.width * dy)] == 0 && opaque_layer->objects[c-(m.width * dy)].gid == 0) &&
-                        !(fov_array[c_fov - (fov_diameter * dy) - dx] && walls_layer->data[c-(m.width * dy) - dx] == 0 && opaque_layer->objects[c-(m.width * dy) - dx].gid == 0))
+                    if (!(fov_array[c_fov - (fov_diameter * dy)] && !tiles.opaque(static_cast<uint32_t>(c-(m.width * dy)))) &&
+                        !(fov_array[c_fov - (fov_diameter * dy) - dx] && !tiles.opaque(static_cast<uint32_t>(c-(m.width * dy) - dx))))
                     {
                         visible = false;
                     } else {
                         for (int32_t idx = 0; idx < obstacles_in_last_line && visible; ++idx) {
-                            if (start_slope <= end_angle[idx] && end_slope >= start_angle[idx]) {
-                                if (walls_layer->data[c] != 0 || object.gid != 0) {
-                                    if (centre_slope > start_angle[idx] && centre_slope < end_angle[idx]) {
+                            if (start_slope <= scratch.end_angle[idx] && end_slope >= scratch.start_angle[idx]) {
+                                if (opaque) {
+                                    if (centre_slope > scratch.start_angle[idx] && centre_slope < scratch.end_angle[idx]) {
                                         visible = false;
                                     }
                                 } else {
-                                    if (start_slope >= start_angle[idx] && end_slope <= end_angle[idx]) {
+                                    if (start_slope >= scratch.start_angle[idx] && end_slope <= scratch.end_angle[idx]) {
                                         visible = false;
                                     } else {
-                                        start_angle[idx] = min(start_angle[idx], start_slope);
-                                        end_angle[idx] = max(end_angle[idx], end_slope);
+                                        scratch.start_angle[idx] = min(scratch.start_angle[idx], start_slope);
+                                        scratch.end_angle[idx] = max(scratch.end_angle[idx], end_slope);
                                         extended = true;
                                     }
                                 }
@@ -131,7 +124,7 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
 
                     fov_array[c_fov] = true;
                     /* if the cell is opaque, block the adjacent slopes */
-                    if (walls_layer->data[c] != 0 || object.gid != 0) {
+                    if (opaque) {
                         if (min_angle >= start_slope) {
                             min_angle = end_slope;
                             /* if min_angle is applied to the last cell in line, nothing more
@@ -140,8 +133,8 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
                                 done = true;
                             }
                         } else if (!extended) {
-                            start_angle[total_obstacles] = start_slope;
-                            end_angle[total_obstacles++] = end_slope;
+                            scratch.start_angle[total_obstacles] = start_slope;
+                            scratch.end_angle[total_obstacles++] = end_slope;
                         }
                         if (!light_walls) {
                             fov_array[c_fov] = false;
@@ -168,7 +161,7 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
         bool done = false;
         int32_t total_obstacles = 0;
         int32_t obstacles_in_last_line = 0;
-        double min_angle = 0.0;
+        int32_t min_angle = 0;
         int32_t x;
         int32_t y;
 
@@ -180,9 +173,9 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
         }
         while (!done) {
             /* process cells in the line */
-            double slopes_per_cell = 1.0 / (double)(iteration);
-            double half_slopes = slopes_per_cell * 0.5;
-            int32_t processed_cell = (int)((min_angle + half_slopes) / slopes_per_cell);
+            int32_t slopes_per_cell = fov_slope_scale / iteration;
+            int32_t half_slopes = slopes_per_cell / 2;
+            int32_t processed_cell = (min_angle + half_slopes) / slopes_per_cell;
             int32_t miny = max(0, player_y - iteration);
             int32_t maxy = min(static_cast<int32_t>(m.height) - 1, player_y + iteration);
             done = true;
@@ -192,37 +185,36 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
                 /* calculate slopes per cell */
                 bool visible = true;
                 bool extended = false;
-                double centre_slope = (double)processed_cell * slopes_per_cell;
-                double start_slope = centre_slope - half_slopes;
-                double end_slope = centre_slope + half_slopes;
-                auto const &object = opaque_layer->objects[c];
+                int32_t centre_slope = processed_cell * slopes_per_cell;
+                int32_t start_slope = centre_slope - half_slopes;
+                int32_t end_slope = centre_slope + half_slopes;
+                bool const opaque = tiles.opaque(static_cast<uint32_t>(c));
 
 #ifdef LOG_FOV_EXTREME
-                spdlog::trace("[{}] horizontal {}:{} c {} wall {}", __FUNCTION__, x, y, c, walls_layer->data[c]);
+                spdlog::trace("[{}] horizontal {}:{} c {} opaque {}", __FUNCTION__, x, y, c, opaque);
 #endif
 
                 if (obstacles_in_last_line > 0) {
-                    if (!(fov_array[c_fov - dx] && walls_layer->data[c-dx] == 0 && opaque_layer->objects[c-dx].gid == 0) &&
-                        !(fov_array[c_fov - (fov_diameter * dy) - dx] && walls_layer->data[c-(m.width * dy) - dx] == 0 && opaque_layer->objects[c-(m.width * dy) - dx].gid == 0))
+                    if (!(fov_array[c_fov - dx] && !tiles.opaque(static_cast<uint32_t>(c-dx))) &&
+                        !(fov_array[c_fov - (fov_diameter * dy) - dx] && !tiles.opaque(static_cast<uint32_t>(c-(m.width * dy) - dx))))
                     {
                         visible = false;
                     } else {
                         for (int32_t idx = 0; idx < obstacles_in_last_line && visible; ++idx) {
-                            if (start_slope <= end_angle[idx] && end_slope >= start_angle[idx]) {
-                                if (walls_layer->data[c] != 0 || object.gid != 0) {
-                                    if (centre_slope > start_angle[idx] && centre_slope < end_angle[idx]) {
+                            if (start_slope <= scratch.end_angle[idx] && end_slope >= scratch.start_angle[idx]) {
+                                if (opaque) {
+                                    if (centre_slope > scratch.start_angle[idx] && centre_slope < scratch.end_angle[idx]) {
                                         visible = false;
                                     }
                                 } else {
-                                    if (start_slope >= start_angle[idx] && end_slope <= end_angle[idx]) {
+                                    if (start_slope >= scratch.start_angle[idx] && end_slope <= scratch.end_angle[idx]) {
                                         visible = false;
                                     } else {
-                                        start_angle[idx] = min(start_angle[idx], start_slope);
-                                        end_angle[idx] = max(end_angle[idx], end_slope);
+                                        scratch.start_angle[idx] = min(scratch.start_angle[idx], start_slope);
+                                        scratch.end_angle[idx] = max(scratch.end_angle[idx], end_slope);
                                         extended = true;
                                     }
                                 }
-                                ++idx;
                             }
                         }
                     }
@@ -231,7 +223,7 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
                     done = false;
                     fov_array[c_fov] = true;
                     /* if the cell is opaque, block the adjacent slopes */
-                    if (walls_layer->data[c] != 0 || object.gid != 0) {
+                    if (opaque) {
                         if (min_angle >= start_slope) {
                             min_angle = end_slope;
                             /* if min_angle is applied to the last cell in line, nothing more
@@ -240,8 +232,8 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
                                 done = true;
                             }
                         } else if (!extended) {
-                            start_angle[total_obstacles] = start_slope;
-                            end_angle[total_obstacles++] = end_slope;
+                            scratch.start_angle[total_obstacles] = start_slope;
+                            scratch.end_angle[total_obstacles++] = end_slope;
                         }
                         if (!light_walls) {
                             fov_array[c_fov] = false;
@@ -265,32 +257,20 @@ bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting_quadrant (map_
     return fov_array;
 }
 
-bitset<power(fov_diameter)> lotr::compute_fov_restrictive_shadowcasting(map_component const &m, location &player_loc, bool const light_walls) {
-    int max_obstacles;
-
-    /* calculate an approximated (excessive, just in case) maximum number of obstacles per octant */
-    max_obstacles = m.width * m.height / 7;
-
-    /* check memory for angles */
-    if (max_obstacles > allocated) {
-        allocated = max_obstacles;
-        start_angle = make_unique<double[]>(max_obstacles);
-        end_angle = make_unique<double[]>(max_obstacles);
-    }
-
+bitset<power(fov_diameter)> lotr::compute_fov_restrictive_shadowcasting(map_component const &m, location const &player_loc, bool const light_walls, fov_scratch &scratch) {
     auto const &walls_layer = m.layers[map_layer_name::Walls];
     auto const &opaque_layer = m.layers[map_layer_name::OpaqueDecor];
 
     if(walls_layer.name.empty() || opaque_layer.name.empty()) {
-        spdlog::error("[{}] missing walls or opaque layer for map {}", m.name);
+        spdlog::error("[{}] missing walls or opaque layer for map {}", __FUNCTION__, m.name);
         return {};
     }
 
     /* compute the 4 quadrants of the map */
-    auto q1_fov = compute_fov_restrictive_shadowcasting_quadrant(m, &walls_layer, &opaque_layer, get<0>(player_loc), get<1>(player_loc), light_walls, 1, 1);
-    auto q2_fov = compute_fov_restrictive_shadowcasting_quadrant(m, &walls_layer, &opaque_layer, get<0>(player_loc), get<1>(player_loc), light_walls, 1, -1);
-    auto q3_fov = compute_fov_restrictive_shadowcasting_quadrant(m, &walls_layer, &opaque_layer, get<0>(player_loc), get<1>(player_loc), light_walls, -1, 1);
-    auto q4_fov = compute_fov_restrictive_shadowcasting_quadrant(m, &walls_layer, &opaque_layer, get<0>(player_loc), get<1>(player_loc), light_walls, -1, -1);
+    auto q1_fov = compute_fov_restrictive_shadowcasting_quadrant(m, m.tiles, get<0>(player_loc), get<1>(player_loc), light_walls, 1, 1, scratch);
+    auto q2_fov = compute_fov_restrictive_shadowcasting_quadrant(m, m.tiles, get<0>(player_loc), get<1>(player_loc), light_walls, 1, -1, scratch);
+    auto q3_fov = compute_fov_restrictive_shadowcasting_quadrant(m, m.tiles, get<0>(player_loc), get<1>(player_loc), light_walls, -1, 1, scratch);
+    auto q4_fov = compute_fov_restrictive_shadowcasting_quadrant(m, m.tiles, get<0>(player_loc), get<1>(player_loc), light_walls, -1, -1, scratch);
 
 #ifdef LOG_FOV_EXTREME
     log_fov(q1_fov | q2_fov | q3_fov | q4_fov, "fov");
@@ -299,6 +279,11 @@ bitset<power(fov_diameter)> lotr::compute_fov_restrictive_shadowcasting(map_comp
     return q1_fov | q2_fov | q3_fov | q4_fov;
 }
 
+bitset<power(fov_diameter)> lotr::compute_fov_restrictive_shadowcasting(map_component const &m, location const &player_loc, bool const light_walls) {
+    fov_scratch scratch;
+    return compute_fov_restrictive_shadowcasting(m, player_loc, light_walls, scratch);
+}
+
 void lotr::log_fov(bitset<power(fov_diameter)> const &fov, string name) {
     for(int32_t y = fov_diameter - 1; y >= 0; y--) {
         string test = ""s;
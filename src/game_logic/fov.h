@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <array>
 #include <bitset>
 #include <game_logic/location.h>
 
@@ -32,10 +33,41 @@ namespace lotr {
         return x * x;
     }
 
+    constexpr uint32_t lcm_up_to(uint32_t n) noexcept {
+        uint32_t ret = 1;
+        for(uint32_t i = 2; i <= n; i++) {
+            uint32_t a = ret;
+            uint32_t b = i;
+            while(b != 0) {
+                auto t = a % b;
+                a = b;
+                b = t;
+            }
+            ret = ret / a * i;
+        }
+        return ret;
+    }
+
+    // slopes are fixed point in units of 1/fov_slope_scale, which makes every cell edge and centre up to fov_max_distance exact
+    constexpr int32_t fov_slope_scale = 2 * lcm_up_to(fov_max_distance);
+
+    // an octant has at most 2 + 3 + ... + (fov_max_distance + 1) cells, each adding at most one obstacle
+    constexpr uint32_t fov_max_obstacles = fov_max_distance * (fov_max_distance + 3) / 2;
+
+    // obstacle angles of the octant being processed, owned by the caller so fov can be computed from any thread
+    struct fov_scratch {
+        array<int32_t, fov_max_obstacles> start_angle;
+        array<int32_t, fov_max_obstacles> end_angle;
+    };
+
     struct map_component;
 
     [[nodiscard]]
-    bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting(map_component const &m, location &player_loc, bool const light_walls);
+    bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting(map_component const &m, location const &player_loc, bool const light_walls, fov_scratch &scratch);
+
+    // uses a scratch on the stack
+    [[nodiscard]]
+    bitset<power(fov_diameter)> compute_fov_restrictive_shadowcasting(map_component const &m, location const &player_loc, bool const light_walls);
 
     void log_fov(bitset<power(fov_diameter)> const &fov, string name);
 }
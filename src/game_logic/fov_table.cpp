@@ -0,0 +1,193 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "fov_table.h"
+
+#include <istream>
+#include <ostream>
+#include <cstring>
+#include <algorithm>
+#include <xxhash.h>
+#include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
+
+using namespace std;
+using namespace lotr;
+
+static constexpr char fov_table_magic[8] = {'L', 'O', 'T', 'R', 'F', 'O', 'V', '\0'};
+static constexpr uint32_t fov_table_version = 2;
+static_assert(fov_table::tile_bytes > sizeof(uint64_t) && fov_table::tile_bytes <= 2 * sizeof(uint64_t), "lookup unpacks a tile into two uint64_t");
+
+template <typename T>
+void write_pod(ostream &out, T const &value) {
+    out.write(reinterpret_cast<char const *>(&value), sizeof(T));
+}
+
+template <typename T>
+bool read_pod(istream &in, T &value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+fov_table::fov_table() noexcept : _width(0), _height(0), _layers_hash(0), _data() {
+
+}
+
+fov_table fov_table::build(map_component const &m) {
+    fov_table table;
+    table._width = m.width;
+    table._height = m.height;
+    table._layers_hash = fov_layers_hash(m);
+    table._data.resize(static_cast<size_t>(m.width) * m.height * tile_bytes);
+
+    for(uint32_t y = 0; y < m.height; y++) {
+        for(uint32_t x = 0; x < m.width; x++) {
+            // players can't stand on unwalkable tiles, leave those empty
+            if(!tile_is_walkable(m, x, y)) {
+                continue;
+            }
+
+            location loc = make_tuple(x, y);
+            auto fov = compute_fov_restrictive_shadowcasting(m, loc, true);
+            auto *tile = &table._data[(x + static_cast<size_t>(y) * m.width) * tile_bytes];
+
+            for(uint32_t i = 0; i < power(fov_diameter); i++) {
+                if(fov[i]) {
+                    tile[i / 8] |= 1U << (i % 8);
+                }
+            }
+        }
+    }
+
+    return table;
+}
+
+bool fov_table::empty() const noexcept {
+    return _data.empty();
+}
+
+bool fov_table::matches(map_component const &m) const noexcept {
+    return _width == m.width && _height == m.height && _layers_hash == fov_layers_hash(m);
+}
+
+bitset<power(fov_diameter)> fov_table::lookup(location const &loc) const noexcept {
+    auto const *tile = &_data[(get<0>(loc) + static_cast<size_t>(get<1>(loc)) * _width) * tile_bytes];
+    uint64_t low = 0;
+    uint64_t high = 0;
+    memcpy(&low, tile, sizeof(low));
+    memcpy(&high, tile + sizeof(low), tile_bytes - sizeof(low));
+
+    bitset<power(fov_diameter)> fov(high);
+    fov <<= 64;
+    fov |= bitset<power(fov_diameter)>(low);
+    return fov;
+}
+
+bool fov_table::load(istream &in, map_component const &m) {
+    char magic[sizeof(fov_table_magic)];
+    uint32_t version;
+
+    if(!in.read(magic, sizeof(magic)) || memcmp(magic, fov_table_magic, sizeof(magic)) != 0) {
+        return false;
+    }
+
+    if(!read_pod(in, version) || version != fov_table_version) {
+        return false;
+    }
+
+    fov_table table;
+    if(!read_pod(in, table._width) || !read_pod(in, table._height) || !read_pod(in, table._layers_hash)) {
+        return false;
+    }
+
+    // check the header before trusting its size, a stale or corrupt file must not cause a huge allocation
+    if(!table.matches(m)) {
+        return false;
+    }
+
+    table._data.resize(static_cast<size_t>(table._width) * table._height * tile_bytes);
+    if(!in.read(reinterpret_cast<char *>(table._data.data()), table._data.size())) {
+        return false;
+    }
+
+    *this = move(table);
+    return true;
+}
+
+void fov_table::save(ostream &out) const {
+    out.write(fov_table_magic, sizeof(fov_table_magic));
+    write_pod(out, fov_table_version);
+    write_pod(out, _width);
+    write_pod(out, _height);
+    write_pod(out, _layers_hash);
+    out.write(reinterpret_cast<char const *>(_data.data()), _data.size());
+}
+
+uint64_t lotr::fov_layers_hash(map_component const &m) noexcept {
+    auto const walls = m.layers[map_layer_name::Walls].data.decode();
+    auto const &objects = m.layers[map_layer_name::OpaqueDecor].objects;
+
+    auto hash = XXH3_64bits(walls.data(), walls.size() * sizeof(uint32_t));
+    for(size_t i = 0; i < objects.size(); i++) {
+        uint32_t const entry[2] = {objects.index_at(i), (begin(objects) + i)->gid};
+        hash = XXH3_64bits_withSeed(entry, sizeof(entry), hash);
+    }
+
+    return hash;
+}
+
+static bitset<power(fov_diameter)> fov_at(map_component const &m, location const &loc, fov_scratch &scratch) {
+    // the table leaves unwalkable tiles empty, tile_is_walkable is false out of bounds as well
+    if(m.fov_cache.empty() || !tile_is_walkable(m, get<0>(loc), get<1>(loc))) {
+        return compute_fov_restrictive_shadowcasting(m, loc, true, scratch);
+    }
+
+    return m.fov_cache.lookup(loc);
+}
+
+bitset<power(fov_diameter)> lotr::get_fov(map_component const &m, location loc) {
+    fov_scratch scratch;
+    return fov_at(m, loc, scratch);
+}
+
+void lotr::get_fov_batch(map_component const &m, vector<location> const &observers, vector<bitset<power(fov_diameter)>> &fovs) {
+    fovs.resize(observers.size());
+    if(observers.empty()) {
+        return;
+    }
+
+    // visit observers grouped by tile, row by row so the table lookups and opacity reads walk memory in order
+    vector<uint32_t> order(observers.size());
+    for(uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    sort(begin(order), end(order), [&observers](uint32_t a, uint32_t b) noexcept {
+        return make_tuple(get<1>(observers[a]), get<0>(observers[a])) < make_tuple(get<1>(observers[b]), get<0>(observers[b]));
+    });
+
+    fov_scratch scratch;
+    for(uint32_t i = 0; i < order.size(); i++) {
+        auto const &loc = observers[order[i]];
+
+        if(i > 0 && loc == observers[order[i - 1]]) {
+            fovs[order[i]] = fovs[order[i - 1]];
+            continue;
+        }
+
+        fovs[order[i]] = fov_at(m, loc, scratch);
+    }
+}
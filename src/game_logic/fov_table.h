@@ -0,0 +1,63 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iosfwd>
+#include <game_logic/fov.h>
+
+using namespace std;
+
+namespace lotr {
+    // Fov of every tile of a map, packed into tile_bytes bytes per tile.
+    // Fov only depends on the static walls and opaque decor layers, so this can be built once at load time and persisted.
+    class fov_table {
+    public:
+        static constexpr uint32_t tile_bytes = (power(fov_diameter) + 7) / 8;
+
+        fov_table() noexcept;
+
+        [[nodiscard]] static fov_table build(map_component const &m);
+
+        [[nodiscard]] bool empty() const noexcept;
+        [[nodiscard]] bool matches(map_component const &m) const noexcept;
+        [[nodiscard]] bitset<power(fov_diameter)> lookup(location const &loc) const noexcept;
+
+        // returns false if the stream does not contain a table for m or is truncated, checks the header before reading the tiles
+        bool load(istream &in, map_component const &m);
+        void save(ostream &out) const;
+
+    private:
+        uint32_t _width;
+        uint32_t _height;
+        uint64_t _layers_hash;
+        vector<uint8_t> _data;
+    };
+
+    // hash of everything fov depends on, used to detect stale persisted tables
+    [[nodiscard]] uint64_t fov_layers_hash(map_component const &m) noexcept;
+
+    // uses the precomputed table if the map has one and loc is walkable, the live algorithm otherwise
+    [[nodiscard]] bitset<power(fov_diameter)> get_fov(map_component const &m, location loc);
+
+    // Fov of every observer on a map, fovs[i] belongs to observers[i]. Observers sharing a tile are computed once,
+    // so crowded towns cost about the number of occupied tiles instead of the number of players.
+    void get_fov_batch(map_component const &m, vector<location> const &observers, vector<bitset<power(fov_diameter)>> &fovs);
+}
@@ -26,107 +26,144 @@ using namespace lotr;
 
 atomic<uint64_t> lotr::npc_id_counter;
 
-optional<npc_component> lotr::create_npc(spawner_npc_id const &spawner_npc_id, map_component const &m, spawner_script *script) {
-    if(spawner_npc_id.sprite.empty()) {
-        spdlog::error("spawner npc {} has no sprites", spawner_npc_id.npc_id);
-        return {};
-    }
-
-    npc_component npc;
-    npc.id = npc_id_counter++;
-    npc.npc_id = spawner_npc_id.npc_id;
-    npc.allegiance = spawner_npc_id.allegiance;
-    npc.alignment = spawner_npc_id.alignment;
-    npc.gender = spawner_npc_id.gender;
-    npc.dir = spawner_npc_id.dir;
-    npc.hostility = spawner_npc_id.hostility;
-    npc.character_class = spawner_npc_id.character_class;
-    npc.monster_class = spawner_npc_id.monster_class;
-    npc.spawn_message = spawner_npc_id.spawn_message;
-    npc.sfx = spawner_npc_id.sfx;
-    npc.level = npc.highest_level = spawner_npc_id.level;
-
-    npc.sprite = spawner_npc_id.sprite[lotr::random.generate_single(0, spawner_npc_id.sprite.size() - 1)];
-    npc.skill_on_kill = spawner_npc_id.skill_on_kill;
-    npc.sfx_max_chance = spawner_npc_id.sfx_max_chance;
-
-    npc.spawner = script;
-
-    if(script->spawn_radius > 0) {
-        bool found_coord = false;
-        while(!found_coord) {
-            auto x = lotr::random.generate_single((uint64_t)get<0>(script->loc) - script->spawn_radius, get<0>(script->loc) + script->spawn_radius);
-            auto y = lotr::random.generate_single((uint64_t)get<1>(script->loc) - script->spawn_radius, get<1>(script->loc) + script->spawn_radius);
-            npc.loc = make_tuple(x, y);
-
-            //spdlog::trace("[{}] c {} npc x {} y {} w {} h {} map {} script x {} script y {} spawn_radius {} wall {} object {}",  __FUNCTION__, c, get<0>(npc.loc), get<1>(npc.loc), m.width, m.height, m.name, get<0>(script->loc), get<1>(script->loc), script->spawn_radius, walls_layer->data[c], opaque_layer->objects[c].gid);
-            if(tile_is_walkable(m, npc.loc)) {
-                found_coord = true;
-            }
+void lotr::remove_dead_npcs(map_component &m) {
+    vector<entt::entity> dead;
+    npc_group(m).each([&](entt::entity npc, position_component &, vitals_component &vitals, ai_component &, spawner_link_component &, npc_component &) {
+        if(vitals.hp <= 0) {
+            dead.push_back(npc);
         }
-    } else {
-        npc.loc = script->loc;
+    });
+
+    for(auto npc : dead) {
+        remove_npc(m, npc);
     }
+}
+
+entt::entity lotr::add_npc(map_component &m, location loc, appearance_component appearance, ai_component ai, entt::entity spawner, npc_component npc) {
+    auto entity = m.entities.create();
+    m.entities.assign<position_component>(entity, loc);
+    m.entities.assign<vitals_component>(entity, npc.stats[StatHp], npc.stats[StatMaxHp], npc.stats[StatMp], npc.stats[StatMaxMp]);
+    m.entities.assign<appearance_component>(entity, move(appearance));
+    m.entities.assign<ai_component>(entity, move(ai));
+    m.entities.assign<spawner_link_component>(entity, spawner);
+    m.entities.assign<npc_component>(entity, move(npc));
+    m.npc_grid.insert(entity, loc);
+    spawner_npc_added(m, spawner);
+
+    // spread first actions over the interval, so npcs spawned together don't all act on the same ticks
+    auto const interval = ai_action_interval(m.entities.get<npc_component>(entity), m.tick_length);
+    m.timers.schedule(entity, AiTimer, m.tick + 1 + lotr::random.generate_single_fast(interval));
+    return entity;
+}
+
+void lotr::remove_npc(map_component &m, entt::entity npc) {
+    auto const spawner = m.entities.get<spawner_link_component>(npc).spawner;
+    m.npc_grid.remove(npc, m.entities.get<position_component>(npc).loc);
+    m.timers.cancel_all(npc);
+    m.entities.destroy(npc);
+    spawner_npc_removed(m, spawner);
+}
+
+void lotr::move_npc(map_component &m, entt::entity npc, location loc) {
+    auto &position = m.entities.get<position_component>(npc);
+    m.npc_grid.move(npc, position.loc, loc);
+    position.loc = loc;
+}
+
+void lotr::reserve_npcs(map_component &m, uint32_t capacity) {
+    m.entities.reserve(capacity);
+    m.entities.reserve<position_component, vitals_component, appearance_component, ai_component, spawner_link_component, npc_component>(capacity);
+}
 
-    for (auto const &stat : stat_names) {
-        auto const random_stat_it = find_if(cbegin(spawner_npc_id.random_stats), cend(spawner_npc_id.random_stats),
-                                            [&](random_stat_component const &rs) noexcept { return rs.name == stat; });
-
-        if (random_stat_it != cend(spawner_npc_id.random_stats)) {
-            npc.stats[stat] = lotr::random.generate_single(random_stat_it->min, random_stat_it->max);
-        } else {
-            auto const stat_it = find_if(cbegin(spawner_npc_id.stats), cend(spawner_npc_id.stats),
-                                         [&](stat_component const &s) noexcept { return s.name == stat; });
-            if (stat_it == cend(spawner_npc_id.stats)) {
-                spdlog::error("[{}] Initializing spawn for spawner_npc_id {} failed, missing stat {}", __FUNCTION__, spawner_npc_id.npc_id, stat);
-                return {};
+void lotr::wake_npcs_near(map_component &m, location loc) {
+    m.npc_grid.for_each_in_range(loc, m.ai_full_radius, [&m](entt::entity npc, location const &) {
+        auto &ai = m.entities.get<ai_component>(npc);
+        if(ai.coarse) {
+            ai.coarse = false;
+            // already waiting in pending_ai, which runs it at full rate and reschedules it
+            if(!ai.pending) {
+                m.timers.schedule(npc, AiTimer, m.tick + 1);
             }
-            npc.stats[stat] = stat_it->value;
         }
+    });
+}
 
-        //spdlog::trace("[{}] Added {}:{} to npc {}:{}", __FUNCTION__, stat, npc.stats[stat], npc.id, npc.name);
-    }
+uint64_t lotr::ai_action_interval(npc_component const &npc, uint32_t tick_length) noexcept {
+    auto const actions_per_second = static_cast<uint64_t>(max<int64_t>(npc.stats[StatActionSpeed], 0)) + 1;
+    return max<uint64_t>(1'000 / (max(tick_length, 1U) * actions_per_second), 1);
+}
 
-    spdlog::debug("[{}] Created npc {}:{}", __FUNCTION__, npc.name, npc.npc_id);
-    return npc;
+entt::entity lotr::add_player(map_component &m, location loc, appearance_component appearance, uint64_t connection_id, pc_component pc) {
+    auto entity = m.entities.create();
+    m.entities.assign<position_component>(entity, loc);
+    m.entities.assign<vitals_component>(entity, pc.stats[StatHp], pc.stats[StatMaxHp], pc.stats[StatMp], pc.stats[StatMaxMp]);
+    m.entities.assign<appearance_component>(entity, move(appearance));
+    m.entities.assign<connection_component>(entity, connection_id);
+    m.entities.assign<pc_component>(entity, move(pc));
+    m.player_grid.insert(entity, loc);
+    m.player_connections[connection_id] = entity;
+    wake_npcs_near(m, loc);
+    return entity;
 }
 
-void lotr::remove_dead_npcs(vector<npc_component> &npcs) noexcept {
-    npcs.erase(remove_if(begin(npcs), end(npcs), [&](npc_component &npc) noexcept { return npc.stats[stat_hp] <= 0; }), end(npcs));
+void lotr::remove_player(map_component &m, entt::entity player) noexcept {
+    m.player_grid.remove(player, m.entities.get<position_component>(player).loc);
+    m.player_connections.erase(m.entities.get<connection_component>(player).connection_id);
+    m.entities.destroy(player);
 }
 
-void lotr::fill_spawners(map_component const &m, vector<npc_component> &npcs, entt::registry &registry) {
-    lotr_flat_map<uint32_t, tuple<uint32_t, spawner_script*>> spawner_npc_counter;
+void lotr::move_player(map_component &m, entt::entity player, location loc) {
+    auto &position = m.entities.get<position_component>(player);
+    m.player_grid.move(player, position.loc, loc);
+    position.loc = loc;
+    wake_npcs_near(m, loc);
+}
 
-    for(auto &npc : npcs) {
-        if(npc.stats[stat_hp] <= 0) {
-            continue;
-        }
+player_index_component& lotr::get_player_index(entt::registry &registry) {
+    auto *index = registry.try_ctx<player_index_component>();
+    if(index == nullptr) {
+        return registry.set<player_index_component>();
+    }
+    return *index;
+}
 
-        if(npc.spawner) {
-            auto spawner_it = spawner_npc_counter.find(npc.spawner->id);
+entt::entity lotr::add_player_to_game(entt::registry &registry, entt::entity map_entity, location loc, appearance_component appearance, uint64_t connection_id, pc_component pc) {
+    auto &index = get_player_index(registry);
+    index.map_by_connection[connection_id] = map_entity;
+    index.connection_by_name[appearance.name] = connection_id;
+    return add_player(registry.get<map_component>(map_entity), loc, move(appearance), connection_id, move(pc));
+}
 
-            if (spawner_it == end(spawner_npc_counter)) {
-                get<0>(spawner_it->second)++;
-            } else {
-                spawner_npc_counter[npc.spawner->id] = make_tuple(1, npc.spawner);
-            }
-        }
-    }
+void lotr::remove_player_from_game(entt::registry &registry, player_handle const &handle) {
+    auto &index = get_player_index(registry);
+    index.map_by_connection.erase(handle.m->entities.get<connection_component>(handle.entity).connection_id);
+    index.connection_by_name.erase(handle.m->entities.get<appearance_component>(handle.entity).name);
+    remove_player(*handle.m, handle.entity);
+}
 
-    for(auto &[k, v] : spawner_npc_counter) {
-        if(get<0>(v) < get<1>(v)->max_creatures) {
-            if(get<1>(v)->npc_ids.empty()) {
-                continue;
-            }
+optional<player_handle> lotr::find_player_by_connection(entt::registry &registry, uint64_t connection_id) {
+    auto &index = get_player_index(registry);
+    auto map_it = index.map_by_connection.find(connection_id);
+    if(map_it == end(index.map_by_connection)) {
+        return nullopt;
+    }
 
-            auto &random_npc_id = get<1>(v)->npc_ids[lotr::random.generate_single(0, get<1>(v)->npc_ids.size() - 1)];
+    auto &m = registry.get<map_component>(map_it->second);
+    auto player_it = m.player_connections.find(connection_id);
+    if(player_it == end(m.player_connections)) {
+        spdlog::error("[{}] conn {} indexed on map {} but not found", __FUNCTION__, connection_id, m.name);
+        return nullopt;
+    }
 
-            auto npc = create_npc(random_npc_id, m, get<1>(v));
+    return player_handle{map_it->second, &m, player_it->second};
+}
 
-            if(npc) {
-                npcs.emplace_back(move(*npc));
-            }
-        }
+optional<player_handle> lotr::find_player_by_name(entt::registry &registry, string const &name) {
+    auto &index = get_player_index(registry);
+    auto it = index.connection_by_name.find(name);
+    if(it == end(index.connection_by_name)) {
+        return nullopt;
     }
+
+    return find_player_by_connection(registry, it->second);
 }
@@ -20,35 +20,56 @@
 
 #include <entt/entt.hpp>
 #include <ecs/components.h>
+#include <game_logic/spawners.h>
 #include <spdlog/spdlog.h>
 
 using namespace std;
 
 namespace lotr {
-    optional<npc_component> create_npc(spawner_npc_id const &spawner_npc_id, map_component const &m, spawner_script *script);
-    void remove_dead_npcs(vector<npc_component> &npcs) noexcept;
-    void fill_spawners(map_component const &m, vector<npc_component> &npcs, entt::registry &registry);
-
-    static bool tile_is_walkable(map_component const &m, int32_t const x, int32_t const y) {
-        auto const &walls_layer = m.layers[map_layer_name::Walls];
-        auto const &opaque_layer = m.layers[map_layer_name::OpaqueDecor];
-
-        if(x < 0 || x >= walls_layer.width || y < 0 || y >= walls_layer.height){
-            return false;
-        }
-
-        uint32_t c = x + y * walls_layer.width;
-
-#ifndef NDEBUG
-        if(c >= walls_layer.data.size()) {
-            spdlog::error("[{}] c larger than walls for map {} {}: {} {}, {} {} {} {}", __FUNCTION__, m.name, walls_layer.name, c, walls_layer.data.size(), x, y, walls_layer.width, walls_layer.height);
-        }
-        if(c >= opaque_layer.objects.size()) {
-            spdlog::error("[{}] c larger than opaque for map {} {}: {} {}, {} {} {} {}", __FUNCTION__, m.name, opaque_layer.name, c, opaque_layer.objects.size(), x, y, opaque_layer.width, opaque_layer.height);
-        }
-#endif
-
-        return walls_layer.data[c] == 0 && opaque_layer.objects[c].gid == 0;
+    void remove_dead_npcs(map_component &m);
+
+    // Every npc has a position, vitals and ai, which the group owns, so iterating it walks those arrays front to back.
+    // Adding or removing npcs invalidates the group iteration, collect entities first when doing so from within.
+    inline auto npc_group(map_component &m) {
+        return m.entities.group<position_component, vitals_component, ai_component>(entt::get<spawner_link_component, npc_component>);
+    }
+
+    // grow npc storage up front, so spawning up to capacity npcs does not reallocate mid tick
+    void reserve_npcs(map_component &m, uint32_t capacity);
+
+    inline auto player_view(map_component &m) {
+        return m.entities.view<connection_component, position_component>();
+    }
+
+    // create and destroy entities on the map and keep map_component::npc_grid and player_grid in sync with their positions,
+    // npcs also keep the counts of their spawner up to date
+    entt::entity add_npc(map_component &m, location loc, appearance_component appearance, ai_component ai, entt::entity spawner, npc_component npc);
+    void remove_npc(map_component &m, entt::entity npc);
+    void move_npc(map_component &m, entt::entity npc, location loc);
+    // npcs near loc that only got the coarse ai update act on the next tick, so they're up to date when a player arrives
+    void wake_npcs_near(map_component &m, location loc);
+    // npcs act once a second plus actionSpeed extra times a second, but at most once a tick
+    [[nodiscard]] uint64_t ai_action_interval(npc_component const &npc, uint32_t tick_length) noexcept;
+    entt::entity add_player(map_component &m, location loc, appearance_component appearance, uint64_t connection_id, pc_component pc);
+    void remove_player(map_component &m, entt::entity player) noexcept;
+    void move_player(map_component &m, entt::entity player, location loc);
+
+    struct player_handle {
+        entt::entity map_entity;
+        map_component *m;
+        entt::entity entity;
+    };
+
+    player_index_component& get_player_index(entt::registry &registry);
+    // add_player and remove_player that also maintain the player index
+    entt::entity add_player_to_game(entt::registry &registry, entt::entity map_entity, location loc, appearance_component appearance, uint64_t connection_id, pc_component pc);
+    void remove_player_from_game(entt::registry &registry, player_handle const &handle);
+    // O(1) lookups through the player index, nullopt if the connection or name is not in game
+    optional<player_handle> find_player_by_connection(entt::registry &registry, uint64_t connection_id);
+    optional<player_handle> find_player_by_name(entt::registry &registry, string const &name);
+
+    inline bool tile_is_walkable(map_component const &m, int32_t const x, int32_t const y) {
+        return m.tiles.walkable(x, y);
     }
 
     inline bool tile_is_walkable(map_component const &m, location const &loc) {
@@ -61,5 +82,6 @@ namespace lotr {
             fov[get<0>(main_entity) - get<0>(other) + fov_max_distance + ((get<1>(other) - get<1>(main_entity) + fov_max_distance) * fov_diameter)] == true;
     }
 
+    // ids for npcs and players alike, clients key map updates on them
     extern atomic<uint64_t> npc_id_counter;
 }
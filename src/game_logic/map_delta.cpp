@@ -0,0 +1,91 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "map_delta.h"
+
+#include <ecs/components.h>
+#include <messages/map_update_response.h>
+#include <messages/map_delta_response.h>
+
+using namespace std;
+using namespace lotr;
+
+unique_ptr<message> lotr::create_map_update(connection_component &connection, vector<visible_entity> const &visible, uint32_t keyframe_interval) {
+    auto const tick = ++connection.update_tick;
+    connection.ticks_since_keyframe++;
+
+    if(connection.keyframe_requested || connection.ticks_since_keyframe >= keyframe_interval) {
+        connection.keyframe_requested = false;
+        connection.ticks_since_keyframe = 0;
+        connection.sent_entities.clear();
+
+        vector<map_delta_entity> entities;
+        entities.reserve(visible.size());
+        for(auto const &v : visible) {
+            auto const &a = *v.appearance;
+            entities.emplace_back(a.id, a.name, a.sprite, v.loc);
+            connection.sent_entities.emplace(a.id, sent_entity_state{a.name, a.sprite, v.loc, tick});
+        }
+
+        return make_unique<map_update_response>(move(entities));
+    }
+
+    vector<map_delta_entity> entered;
+    vector<map_delta_entity> changed;
+    vector<map_delta_move> moved;
+    vector<uint64_t> left;
+
+    for(auto const &v : visible) {
+        auto const &a = *v.appearance;
+        auto it = connection.sent_entities.find(a.id);
+
+        if(it == end(connection.sent_entities)) {
+            entered.emplace_back(a.id, a.name, a.sprite, v.loc);
+            connection.sent_entities.emplace(a.id, sent_entity_state{a.name, a.sprite, v.loc, tick});
+            continue;
+        }
+
+        auto &state = it->second;
+        if(state.sprite != a.sprite || state.name != a.name) {
+            changed.emplace_back(a.id, a.name, a.sprite, v.loc);
+            state.name = a.name;
+            state.sprite = a.sprite;
+        } else if(state.loc != v.loc) {
+            moved.emplace_back(a.id, v.loc);
+        }
+
+        state.loc = v.loc;
+        state.seen_tick = tick;
+    }
+
+    for(auto const &[id, state] : connection.sent_entities) {
+        if(state.seen_tick != tick) {
+            left.push_back(id);
+        }
+    }
+
+    for(auto id : left) {
+        connection.sent_entities.erase(id);
+    }
+
+    if(entered.empty() && changed.empty() && moved.empty() && left.empty()) {
+        return nullptr;
+    }
+
+    return make_unique<map_delta_response>(move(entered), move(changed), move(moved), move(left));
+}
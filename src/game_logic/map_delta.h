@@ -0,0 +1,42 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <messages/message.h>
+#include <game_logic/location.h>
+
+using namespace std;
+
+namespace lotr {
+    struct connection_component;
+    struct appearance_component;
+
+    // an entity as seen by a connection this tick
+    struct visible_entity {
+        appearance_component const *appearance;
+        location loc;
+    };
+
+    // Full map_update_response on the first tick, when the client asked for a resync or every keyframe_interval ticks,
+    // a map_delta_response against what was sent before otherwise. Returns nullptr when nothing changed.
+    [[nodiscard]]
+    unique_ptr<message> create_map_update(connection_component &connection, vector<visible_entity> const &visible, uint32_t keyframe_interval);
+}
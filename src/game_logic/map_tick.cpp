@@ -0,0 +1,147 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "map_tick.h"
+
+#include <game_logic/fov_table.h>
+#include <game_logic/logic_helpers.h>
+#include <game_logic/map_delta.h>
+#include <ai/default_ai.h>
+
+using namespace std;
+
+namespace lotr {
+    // how many entries to run between looking at the clock
+    constexpr uint32_t pending_batch_size = 16;
+
+    // Runs f for the entries of pending in order, until the deadline passes. The first batch always runs, so pending work
+    // can't starve. What is left moves to the front and goes first next tick.
+    template <typename Func>
+    uint32_t run_pending(vector<entt::entity> &pending, chrono::steady_clock::time_point deadline, Func &&f) {
+        uint32_t done = 0;
+        while(done < pending.size()) {
+            auto const batch_end = min(done + pending_batch_size, static_cast<uint32_t>(pending.size()));
+            for(; done < batch_end; done++) {
+                f(pending[done]);
+            }
+
+            if(chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+        }
+
+        pending.erase(begin(pending), begin(pending) + done);
+        return pending.size();
+    }
+
+    void run_timers(map_component &m) {
+        m.timers.advance(m.tick, [&m](timer_kind kind, entt::entity entity) {
+            switch(kind) {
+                case RespawnTimer:
+                    m.pending_respawns.push_back(entity);
+                    break;
+                case AiTimer:
+                    m.entities.get<ai_component>(entity).pending = true;
+                    m.pending_ai.push_back(entity);
+                    break;
+                default:
+                    spdlog::error("[{}] unknown timer kind {} on map {}", __FUNCTION__, static_cast<uint32_t>(kind), m.name);
+                    break;
+            }
+        });
+    }
+
+    uint32_t run_pending_respawns(map_component &m, chrono::steady_clock::time_point deadline) {
+        auto const left = run_pending(m.pending_respawns, deadline, [&m](entt::entity spawner) { respawn(m, spawner); });
+        m.deferred_work += left;
+        return left;
+    }
+
+    uint32_t run_pending_ai(map_component &m, chrono::steady_clock::time_point deadline) {
+        auto const left = run_pending(m.pending_ai, deadline, [&m](entt::entity npc) { run_scheduled_ai(m, npc); });
+        m.deferred_work += left;
+        return left;
+    }
+
+    void tick_map(map_component &m, entt::registry &registry, vector<outward_message> &outbox, uint32_t keyframe_interval, chrono::steady_clock::time_point deadline,
+                  tick_phase_timings &timings) {
+        auto map_start = chrono::steady_clock::now();
+        m.tick++;
+
+        // nobody to see what happens, the timers catch up on the next tick that runs them
+        if(m.player_connections.empty() && m.dormant_interval > 1 && m.tick % m.dormant_interval != 0) {
+            timings[Total] += elapsed_ns(map_start);
+            return;
+        }
+
+        vector<visible_entity> visible;
+        vector<location> observers;
+        vector<bitset<power(fov_diameter)>> fovs;
+        auto players = player_view(m);
+
+        auto phase_start = chrono::steady_clock::now();
+        observers.reserve(m.player_connections.size());
+        players.each([&](connection_component &, position_component &position) {
+            observers.push_back(position.loc);
+        });
+        get_fov_batch(m, observers, fovs);
+        timings[Fov] += elapsed_ns(phase_start);
+
+        phase_start = chrono::steady_clock::now();
+        uint32_t observer = 0;
+        players.each([&](entt::entity player, connection_component &connection, position_component &position) {
+            auto const &loc = position.loc;
+            connection.fov = fovs[observer++];
+
+            int32_t min_x = get<0>(loc) - fov_max_distance;
+            int32_t min_y = get<1>(loc) - fov_max_distance;
+            int32_t max_x = get<0>(loc) + fov_max_distance;
+            int32_t max_y = get<1>(loc) + fov_max_distance;
+            visible.clear();
+
+            m.npc_grid.for_each_in_window(min_x, min_y, max_x, max_y, [&](entt::entity npc, location const &other) {
+                if(is_visible(loc, other, connection.fov, min_x, max_x, min_y, max_y)) {
+                    visible.push_back(visible_entity{&m.entities.get<appearance_component>(npc), other});
+                }
+            });
+
+            m.player_grid.for_each_in_window(min_x, min_y, max_x, max_y, [&](entt::entity other_player, location const &other) {
+                if(is_visible(loc, other, connection.fov, min_x, max_x, min_y, max_y) && other_player != player) {
+                    visible.push_back(visible_entity{&m.entities.get<appearance_component>(other_player), other});
+                }
+            });
+
+            auto update = create_map_update(connection, visible, keyframe_interval);
+            if(update) {
+                outbox.emplace_back(connection.connection_id, move(update));
+            }
+        });
+        timings[Visibility] += elapsed_ns(phase_start);
+
+        phase_start = chrono::steady_clock::now();
+        remove_dead_npcs(m);
+        run_timers(m);
+        run_pending_respawns(m, deadline);
+        timings[Spawning] += elapsed_ns(phase_start);
+
+        phase_start = chrono::steady_clock::now();
+        run_pending_ai(m, deadline);
+        timings[Ai] += elapsed_ns(phase_start);
+        timings[Total] += elapsed_ns(map_start);
+    }
+}
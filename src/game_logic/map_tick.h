@@ -0,0 +1,44 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <chrono>
+#include <entt/entt.hpp>
+#include <ecs/components.h>
+#include <messages/message.h>
+#include <metrics/tick_profiler.h>
+
+using namespace std;
+
+namespace lotr {
+    // fires the timers of the map due at m.tick, adding their entities to the pending work of the map
+    void run_timers(map_component &m);
+    // run pending work until the deadline passes, returns how much is left for the next tick
+    uint32_t run_pending_respawns(map_component &m, chrono::steady_clock::time_point deadline);
+    uint32_t run_pending_ai(map_component &m, chrono::steady_clock::time_point deadline);
+
+    // Computes fov and map updates for every player, removes dead npcs, runs the map timers, respawns and the ai of the npcs due to act.
+    // Map updates always go out, respawns and ai stop at the deadline and continue next tick where they left off.
+    // Maps without players only do this every m.dormant_interval ticks.
+    // Only touches the given map, so separate maps can be ticked on separate threads. Time spent per phase is added to timings.
+    // Players get a full map update every keyframe_interval ticks and only deltas in between.
+    void tick_map(map_component &m, entt::registry &registry, vector<outward_message> &outbox, uint32_t keyframe_interval, chrono::steady_clock::time_point deadline,
+                  tick_phase_timings &timings);
+}
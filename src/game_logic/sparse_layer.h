@@ -0,0 +1,109 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+namespace lotr {
+    // Per tile layer that only stores the tiles that have a value, as a sorted list of tile indices next to a dense array of values.
+    // An occupancy bit per tile keeps the "is there anything here" check O(1), lookups of the value itself are a binary search.
+    template <typename T>
+    class sparse_layer {
+    public:
+        sparse_layer() noexcept : _tile_count(0), _occupied(), _indices(), _values() {}
+        sparse_layer(uint32_t width, uint32_t height) : _tile_count(static_cast<size_t>(width) * height), _occupied((_tile_count + 63) / 64), _indices(), _values() {}
+
+        [[nodiscard]] bool occupied(uint32_t idx) const noexcept {
+            return idx < _tile_count && ((_occupied[idx >> 6U] >> (idx & 63U)) & 1U);
+        }
+
+        // nullptr if there is nothing on the tile
+        [[nodiscard]] T *find(uint32_t idx) noexcept {
+            return const_cast<T*>(static_cast<sparse_layer const &>(*this).find(idx));
+        }
+
+        [[nodiscard]] T const *find(uint32_t idx) const noexcept {
+            if(!occupied(idx)) {
+                return nullptr;
+            }
+
+            auto it = lower_bound(_indices.cbegin(), _indices.cend(), idx);
+            return &_values[distance(_indices.cbegin(), it)];
+        }
+
+        // replaces the value if the tile already has one, throws out_of_range if idx is not a tile of this layer
+        T &insert(uint32_t idx, T value) {
+            if(idx >= _tile_count) {
+                throw out_of_range("sparse_layer insert out of bounds");
+            }
+
+            auto it = lower_bound(_indices.begin(), _indices.end(), idx);
+            auto const pos = distance(_indices.begin(), it);
+
+            if(occupied(idx)) {
+                _values[pos] = move(value);
+                return _values[pos];
+            }
+
+            _occupied[idx >> 6U] |= 1ULL << (idx & 63U);
+            _indices.insert(it, idx);
+            return *_values.insert(_values.begin() + pos, move(value));
+        }
+
+        // tile index of the i-th value, in the same order as iterating
+        [[nodiscard]] uint32_t index_at(size_t i) const noexcept {
+            return _indices[i];
+        }
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _values.size();
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _values.empty();
+        }
+
+        [[nodiscard]] size_t tile_count() const noexcept {
+            return _tile_count;
+        }
+
+        void shrink_to_fit() {
+            _indices.shrink_to_fit();
+            _values.shrink_to_fit();
+        }
+
+        // iterates over the values only, ordered by tile index
+        auto begin() noexcept { return _values.begin(); }
+        auto end() noexcept { return _values.end(); }
+        auto begin() const noexcept { return _values.begin(); }
+        auto end() const noexcept { return _values.end(); }
+
+    private:
+        size_t _tile_count;
+        vector<uint64_t> _occupied;
+        vector<uint32_t> _indices;
+        vector<T> _values;
+    };
+}
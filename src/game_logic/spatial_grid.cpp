@@ -0,0 +1,93 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spatial_grid.h"
+
+#include <spdlog/spdlog.h>
+
+using namespace std;
+using namespace lotr;
+
+spatial_grid::spatial_grid() noexcept : _cells(), _columns(0), _rows(0), _size(0) {
+
+}
+
+spatial_grid::spatial_grid(uint32_t width, uint32_t height) : _cells(), _columns(max((width + cell_size - 1) >> cell_shift, 1U)),
+    _rows(max((height + cell_size - 1) >> cell_shift, 1U)), _size(0) {
+    _cells.resize(_columns * _rows);
+}
+
+void spatial_grid::insert(entt::entity entity, location loc) {
+    if(_cells.empty()) {
+        _columns = _rows = 1;
+        _cells.resize(1);
+    }
+
+    _cells[cell_of(loc)].emplace_back(entity, loc);
+    _size++;
+}
+
+bool spatial_grid::remove(entt::entity entity, location loc) noexcept {
+    if(!_cells.empty()) {
+        auto &cell = _cells[cell_of(loc)];
+        auto it = find_if(begin(cell), end(cell), [entity](spatial_entry const &entry) noexcept { return entry.entity == entity; });
+
+        if(it != end(cell)) {
+            *it = cell.back();
+            cell.pop_back();
+            _size--;
+            return true;
+        }
+    }
+
+    spdlog::error("[{}] entity {} not found at {} {}", __FUNCTION__, static_cast<uint32_t>(entity), get<0>(loc), get<1>(loc));
+    return false;
+}
+
+bool spatial_grid::move(entt::entity entity, location from, location to) {
+    if(!_cells.empty() && cell_of(from) == cell_of(to)) {
+        for(auto &entry : _cells[cell_of(from)]) {
+            if(entry.entity == entity) {
+                entry.loc = to;
+                return true;
+            }
+        }
+
+        spdlog::error("[{}] entity {} not found at {} {}", __FUNCTION__, static_cast<uint32_t>(entity), get<0>(from), get<1>(from));
+        return false;
+    }
+
+    // an entity that was never registered stays out of the grid
+    if(!remove(entity, from)) {
+        return false;
+    }
+
+    insert(entity, to);
+    return true;
+}
+
+void spatial_grid::clear() noexcept {
+    for(auto &cell : _cells) {
+        cell.clear();
+    }
+    _size = 0;
+}
+
+uint32_t spatial_grid::size() const noexcept {
+    return _size;
+}
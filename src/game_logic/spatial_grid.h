@@ -0,0 +1,103 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <entt/entity/registry.hpp>
+#include "location.h"
+
+using namespace std;
+
+namespace lotr {
+    struct spatial_entry {
+        entt::entity entity;
+        location loc;
+
+        spatial_entry(entt::entity entity, location loc) noexcept : entity(entity), loc(loc) {}
+    };
+
+    // Uniform grid of cell_size x cell_size buckets, storing entities together with their location.
+    // Locations outside of the map are kept in the nearest edge cell, so they're still found by queries covering them.
+    class spatial_grid {
+    public:
+        // 8x8 cells means the 9x9 fov window never touches more than 2x2 cells
+        static constexpr uint32_t cell_shift = 3;
+        static constexpr uint32_t cell_size = 1U << cell_shift;
+
+        spatial_grid() noexcept;
+        spatial_grid(uint32_t width, uint32_t height);
+
+        void insert(entt::entity entity, location loc);
+        // both return false and leave the grid untouched if entity isn't at from/loc
+        bool remove(entt::entity entity, location loc) noexcept;
+        bool move(entt::entity entity, location from, location to);
+        void clear() noexcept;
+
+        [[nodiscard]] uint32_t size() const noexcept;
+
+        // calls f(entity, loc) for every entity with min <= loc <= max, bounds inclusive
+        template <typename Func>
+        void for_each_in_window(int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y, Func &&f) const {
+            if(_cells.empty() || min_x > max_x || min_y > max_y) {
+                return;
+            }
+
+            auto const min_column = column_of(min_x);
+            auto const max_column = column_of(max_x);
+            auto const min_row = row_of(min_y);
+            auto const max_row = row_of(max_y);
+
+            for(uint32_t row = min_row; row <= max_row; row++) {
+                for(uint32_t column = min_column; column <= max_column; column++) {
+                    for(auto const &entry : _cells[column + row * _columns]) {
+                        if(get<0>(entry.loc) >= min_x && get<0>(entry.loc) <= max_x && get<1>(entry.loc) >= min_y && get<1>(entry.loc) <= max_y) {
+                            f(entry.entity, entry.loc);
+                        }
+                    }
+                }
+            }
+        }
+
+        // square range, same as the 8 way movement distance
+        template <typename Func>
+        void for_each_in_range(location center, int32_t radius, Func &&f) const {
+            for_each_in_window(get<0>(center) - radius, get<1>(center) - radius, get<0>(center) + radius, get<1>(center) + radius, forward<Func>(f));
+        }
+
+    private:
+        [[nodiscard]] uint32_t column_of(int32_t x) const noexcept {
+            return min(static_cast<uint32_t>(max(x, 0)) >> cell_shift, _columns - 1);
+        }
+
+        [[nodiscard]] uint32_t row_of(int32_t y) const noexcept {
+            return min(static_cast<uint32_t>(max(y, 0)) >> cell_shift, _rows - 1);
+        }
+
+        [[nodiscard]] uint32_t cell_of(location loc) const noexcept {
+            return column_of(get<0>(loc)) + row_of(get<1>(loc)) * _columns;
+        }
+
+        vector<vector<spatial_entry>> _cells;
+        uint32_t _columns;
+        uint32_t _rows;
+        uint32_t _size;
+    };
+}
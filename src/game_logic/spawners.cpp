@@ -0,0 +1,210 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "spawners.h"
+
+#include <spdlog/spdlog.h>
+#include <game_logic/logic_helpers.h>
+#include <game_logic/random_helper.h>
+
+using namespace std;
+using namespace lotr;
+
+entt::entity lotr::add_spawner(map_component &m, spawner_script script) {
+    spawner_state_component state;
+    // respawn_rate is in seconds
+    state.respawn_ticks = max<uint64_t>(static_cast<uint64_t>(script.respawn_rate) * 1'000 / max(m.tick_length, 1U), 1);
+
+    if(script.spawn_radius > 0) {
+        auto const radius = static_cast<int32_t>(script.spawn_radius);
+        for(int32_t y = get<1>(script.loc) - radius; y <= get<1>(script.loc) + radius; y++) {
+            for(int32_t x = get<0>(script.loc) - radius; x <= get<0>(script.loc) + radius; x++) {
+                if(tile_is_walkable(m, x, y)) {
+                    state.spawn_tiles.emplace_back(x, y);
+                }
+            }
+        }
+
+        if(state.spawn_tiles.empty()) {
+            spdlog::error("[{}] spawner {} at {} {} on map {} has no walkable tiles within radius {}", __FUNCTION__, script.id, get<0>(script.loc), get<1>(script.loc), m.name, script.spawn_radius);
+        }
+    }
+
+    if(state.spawn_tiles.empty()) {
+        state.spawn_tiles.push_back(script.loc);
+    }
+
+    auto entity = m.entities.create();
+    m.entities.assign<spawner_script>(entity, move(script));
+    m.entities.assign<spawner_state_component>(entity, move(state));
+    return entity;
+}
+
+spawner_script* lotr::get_spawner(map_component &m, entt::entity spawner) noexcept {
+    if(spawner == entt::null || !m.entities.valid(spawner)) {
+        return nullptr;
+    }
+
+    return m.entities.try_get<spawner_script>(spawner);
+}
+
+optional<entt::entity> lotr::spawn_npc(spawner_npc_id const &spawner_npc_id, map_component &m, entt::entity spawner) {
+    auto *state = spawner != entt::null && m.entities.valid(spawner) ? m.entities.try_get<spawner_state_component>(spawner) : nullptr;
+    if(state == nullptr) {
+        spdlog::error("[{}] spawner for npc {} does not exist", __FUNCTION__, spawner_npc_id.npc_id.str());
+        return {};
+    }
+
+    if(spawner_npc_id.sprite.empty()) {
+        spdlog::error("spawner npc {} has no sprites", spawner_npc_id.npc_id.str());
+        return {};
+    }
+
+    npc_component npc;
+    npc.npc_id = spawner_npc_id.npc_id;
+    npc.allegiance = spawner_npc_id.allegiance;
+    npc.alignment = spawner_npc_id.alignment;
+    npc.gender = spawner_npc_id.gender;
+    npc.character_class = spawner_npc_id.character_class;
+    npc.monster_class = spawner_npc_id.monster_class;
+    npc.spawn_message = spawner_npc_id.spawn_message;
+    npc.sfx = spawner_npc_id.sfx;
+    npc.level = npc.highest_level = spawner_npc_id.level;
+    npc.skill_on_kill = spawner_npc_id.skill_on_kill;
+    npc.sfx_max_chance = spawner_npc_id.sfx_max_chance;
+
+    appearance_component appearance(npc_id_counter++, "", spawner_npc_id.sprite[lotr::random.generate_single(0, spawner_npc_id.sprite.size() - 1)]);
+    appearance.dir = spawner_npc_id.dir;
+
+    ai_component ai;
+    ai.hostility = spawner_npc_id.hostility;
+
+    auto const loc = state->spawn_tiles[lotr::random.generate_single(0, state->spawn_tiles.size() - 1)];
+
+    array<bool, StatCount> stat_set{};
+    for (auto const &stat : spawner_npc_id.stats) {
+        auto const id = stat_id_from_name(stat.name);
+        if (!id) {
+            spdlog::warn("[{}] spawner_npc_id {} has unknown stat {}", __FUNCTION__, spawner_npc_id.npc_id.str(), stat.name);
+            continue;
+        }
+        npc.stats[*id] = stat.value;
+        stat_set[*id] = true;
+    }
+
+    for (auto const &stat : spawner_npc_id.random_stats) {
+        auto const id = stat_id_from_name(stat.name);
+        if (!id) {
+            spdlog::warn("[{}] spawner_npc_id {} has unknown random stat {}", __FUNCTION__, spawner_npc_id.npc_id.str(), stat.name);
+            continue;
+        }
+        npc.stats[*id] = lotr::random.generate_single(stat.min, stat.max);
+        stat_set[*id] = true;
+    }
+
+    for (uint32_t i = 0; i < StatCount; i++) {
+        if (!stat_set[i]) {
+            spdlog::error("[{}] Initializing spawn for spawner_npc_id {} failed, missing stat {}", __FUNCTION__, spawner_npc_id.npc_id.str(), stat_name_table[i]);
+            return {};
+        }
+    }
+
+    spdlog::debug("[{}] Created npc {}:{}", __FUNCTION__, appearance.id, npc.npc_id.str());
+    return add_npc(m, loc, move(appearance), move(ai), spawner, move(npc));
+}
+
+optional<entt::entity> lotr::spawn_random_npc(map_component &m, entt::entity spawner) {
+    auto *script = get_spawner(m, spawner);
+    if(script == nullptr || script->npc_ids.empty()) {
+        return {};
+    }
+
+    auto const &npc_id = script->npc_ids[lotr::random.generate_single(0, script->npc_ids.size() - 1)];
+    return spawn_npc(npc_id, m, spawner);
+}
+
+void lotr::spawner_npc_added(map_component &m, entt::entity spawner) noexcept {
+    if(spawner == entt::null || !m.entities.valid(spawner)) {
+        return;
+    }
+
+    auto *state = m.entities.try_get<spawner_state_component>(spawner);
+    if(state != nullptr) {
+        state->alive++;
+        state->spawned++;
+    }
+}
+
+void lotr::spawner_npc_removed(map_component &m, entt::entity spawner) {
+    if(spawner == entt::null || !m.entities.valid(spawner)) {
+        return;
+    }
+
+    auto *state = m.entities.try_get<spawner_state_component>(spawner);
+    if(state == nullptr) {
+        return;
+    }
+
+    if(state->alive == 0) {
+        spdlog::error("[{}] spawner {} on map {} lost an npc it did not count", __FUNCTION__, static_cast<uint32_t>(spawner), m.name);
+        return;
+    }
+
+    state->alive--;
+    schedule_respawn(m, spawner);
+}
+
+void lotr::schedule_respawn(map_component &m, entt::entity spawner) {
+    auto *script = get_spawner(m, spawner);
+    auto *state = m.entities.try_get<spawner_state_component>(spawner);
+    if(script == nullptr || state == nullptr || script->npc_ids.empty() || m.timers.is_scheduled(spawner, RespawnTimer)) {
+        return;
+    }
+
+    if(state->alive >= script->max_creatures || (script->max_spawn > 0 && state->spawned >= script->max_spawn)) {
+        return;
+    }
+
+    if(script->require_dead_to_respawn && state->alive > 0) {
+        return;
+    }
+
+    state->next_respawn_tick = m.tick + state->respawn_ticks;
+    m.timers.schedule(spawner, RespawnTimer, state->next_respawn_tick);
+}
+
+void lotr::respawn(map_component &m, entt::entity spawner) {
+    auto *script = get_spawner(m, spawner);
+    auto *state = script != nullptr ? m.entities.try_get<spawner_state_component>(spawner) : nullptr;
+    if(state == nullptr) {
+        return;
+    }
+
+    // dormant maps run their timers late, catch up on the respawns that were due in the meantime
+    auto const respawns = 1 + (m.tick - min(m.tick, state->next_respawn_tick)) / state->respawn_ticks;
+
+    // spawners that need everything dead come back at full strength, the others refill one npc per respawn
+    auto const target = script->require_dead_to_respawn ? script->max_creatures : min<uint64_t>(state->alive + respawns, script->max_creatures);
+    while(state->alive < target && (script->max_spawn == 0 || state->spawned < script->max_spawn)) {
+        if(!spawn_random_npc(m, spawner)) {
+            break;
+        }
+    }
+
+    schedule_respawn(m, spawner);
+}
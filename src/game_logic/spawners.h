@@ -0,0 +1,50 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <optional>
+#include <entt/entity/registry.hpp>
+#include <ecs/components.h>
+
+using namespace std;
+
+namespace lotr {
+    // Spawners are entities on the map with a spawner_script and a spawner_state_component. Npc counts are kept up to date
+    // by add_npc and remove_npc, and respawns are RespawnTimer timers on map_component::timers, so a tick only does spawning
+    // work for spawners that are due.
+
+    // precomputes the spawn tiles and converts the respawn rate to ticks of the map
+    entt::entity add_spawner(map_component &m, spawner_script script);
+    // nullptr if the handle is null or the spawner is gone
+    spawner_script* get_spawner(map_component &m, entt::entity spawner) noexcept;
+
+    // creates an npc entity on the map from an entry of the given spawner, nullopt if the entry is incomplete
+    optional<entt::entity> spawn_npc(spawner_npc_id const &spawner_npc_id, map_component &m, entt::entity spawner);
+    // spawns a random npc of the spawner
+    optional<entt::entity> spawn_random_npc(map_component &m, entt::entity spawner);
+
+    // called by add_npc and remove_npc
+    void spawner_npc_added(map_component &m, entt::entity spawner) noexcept;
+    void spawner_npc_removed(map_component &m, entt::entity spawner);
+
+    // schedules a respawn if the spawner has room for more npcs and none is scheduled yet
+    void schedule_respawn(map_component &m, entt::entity spawner);
+    // called when the RespawnTimer of the spawner fires
+    void respawn(map_component &m, entt::entity spawner);
+}
@@ -0,0 +1,61 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tile_bitplanes.h"
+
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+tile_bitplanes::tile_bitplanes() noexcept : _width(0), _height(0), _walkable(), _opaque(), _neighbours() {
+
+}
+
+tile_bitplanes::tile_bitplanes(uint32_t width, uint32_t height, map_layer const &walls_layer, map_layer const &opaque_layer) : _width(width), _height(height),
+    _walkable((static_cast<size_t>(width) * height + 63) / 64), _opaque((static_cast<size_t>(width) * height + 63) / 64), _neighbours(static_cast<size_t>(width) * height) {
+
+    for(uint32_t y = 0; y < height; y++) {
+        for(uint32_t x = 0; x < width; x++) {
+            auto const idx = x + y * width;
+            auto const c = x + y * walls_layer.width;
+
+            // tiles outside the walls layer block everything, like tile_is_walkable always did. A missing or empty opaque layer blocks nothing.
+            bool const covered = x < walls_layer.width && y < walls_layer.height && c < walls_layer.data.size();
+            bool const blocked = !covered || walls_layer.data[c] != 0 || (opaque_layer.objects.occupied(c) && opaque_layer.objects.find(c)->gid != 0);
+
+            if(!blocked) {
+                _walkable[idx >> 6U] |= 1ULL << (idx & 63U);
+            } else {
+                _opaque[idx >> 6U] |= 1ULL << (idx & 63U);
+            }
+        }
+    }
+
+    for(uint32_t y = 0; y < height; y++) {
+        for(uint32_t x = 0; x < width; x++) {
+            uint8_t mask = 0;
+            for(uint32_t i = 0; i < neighbour_offsets.size(); i++) {
+                if(walkable(static_cast<int32_t>(x) + get<0>(neighbour_offsets[i]), static_cast<int32_t>(y) + get<1>(neighbour_offsets[i]))) {
+                    mask |= 1U << i;
+                }
+            }
+            _neighbours[x + y * width] = mask;
+        }
+    }
+}
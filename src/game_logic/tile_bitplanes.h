@@ -0,0 +1,81 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include "location.h"
+
+using namespace std;
+
+namespace lotr {
+    struct map_layer;
+
+    // offsets of the neighbours in the order of the bits in tile_bitplanes::walkable_neighbours
+    constexpr array<location, 8> neighbour_offsets{location{-1, -1}, location{0, -1}, location{1, -1}, location{-1, 0}, location{1, 0}, location{-1, 1}, location{0, 1},
+                                                   location{1, 1}};
+
+    // Walkability and opacity of every tile of a map as one bit per tile, plus a byte per tile telling which of its 8 neighbours
+    // are walkable. Derived from the walls and opaque decor layers when the map is created, so the hot paths don't have to go
+    // through the layers' full map_object structs.
+    class tile_bitplanes {
+    public:
+        tile_bitplanes() noexcept;
+        tile_bitplanes(uint32_t width, uint32_t height, map_layer const &walls_layer, map_layer const &opaque_layer);
+
+        // tiles outside of the map are neither walkable nor see through
+        [[nodiscard]] bool walkable(int32_t x, int32_t y) const noexcept {
+            return in_bounds(x, y) && walkable(index_of(x, y));
+        }
+
+        [[nodiscard]] bool opaque(int32_t x, int32_t y) const noexcept {
+            return !in_bounds(x, y) || opaque(index_of(x, y));
+        }
+
+        // bit i is set when the tile at neighbour_offsets[i] is walkable
+        [[nodiscard]] uint8_t walkable_neighbours(int32_t x, int32_t y) const noexcept {
+            return in_bounds(x, y) ? _neighbours[index_of(x, y)] : 0;
+        }
+
+        // by tile index x + y * width, which has to be in bounds
+        [[nodiscard]] bool walkable(uint32_t idx) const noexcept {
+            return (_walkable[idx >> 6U] >> (idx & 63U)) & 1U;
+        }
+
+        [[nodiscard]] bool opaque(uint32_t idx) const noexcept {
+            return (_opaque[idx >> 6U] >> (idx & 63U)) & 1U;
+        }
+
+    private:
+        [[nodiscard]] bool in_bounds(int32_t x, int32_t y) const noexcept {
+            return x >= 0 && y >= 0 && static_cast<uint32_t>(x) < _width && static_cast<uint32_t>(y) < _height;
+        }
+
+        [[nodiscard]] uint32_t index_of(int32_t x, int32_t y) const noexcept {
+            return static_cast<uint32_t>(x) + static_cast<uint32_t>(y) * _width;
+        }
+
+        uint32_t _width;
+        uint32_t _height;
+        vector<uint64_t> _walkable;
+        vector<uint64_t> _opaque;
+        vector<uint8_t> _neighbours;
+    };
+}
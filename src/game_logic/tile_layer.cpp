@@ -0,0 +1,120 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "tile_layer.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <lotr_flat_map.h>
+
+using namespace std;
+using namespace lotr;
+
+tile_layer::tile_layer() noexcept : _size(0), _index_bytes(0), _palette(), _indices() {
+
+}
+
+tile_layer::tile_layer(vector<uint32_t> const &gids) : _size(gids.size()), _index_bytes(0), _palette(), _indices() {
+    if(gids.empty()) {
+        return;
+    }
+
+    lotr_flat_map<uint32_t, uint32_t> palette_indices;
+    for(auto gid : gids) {
+        if(palette_indices.find(gid) == end(palette_indices)) {
+            palette_indices.emplace(gid, static_cast<uint32_t>(_palette.size()));
+            _palette.push_back(gid);
+        }
+    }
+
+    if(_palette.size() == 1) {
+        return;
+    }
+
+    if(_palette.size() <= 1U << 8U) {
+        _index_bytes = 1;
+    } else if(_palette.size() <= 1U << 16U) {
+        _index_bytes = 2;
+    } else {
+        _index_bytes = 4;
+        _palette.clear();
+        _palette.shrink_to_fit();
+    }
+
+    _indices.resize(_size * _index_bytes);
+    for(size_t i = 0; i < _size; i++) {
+        switch(_index_bytes) {
+            case 1:
+                _indices[i] = static_cast<uint8_t>(palette_indices.find(gids[i])->second);
+                break;
+            case 2: {
+                auto const idx = static_cast<uint16_t>(palette_indices.find(gids[i])->second);
+                memcpy(&_indices[i * 2], &idx, sizeof(idx));
+                break;
+            }
+            default:
+                memcpy(&_indices[i * 4], &gids[i], sizeof(uint32_t));
+                break;
+        }
+    }
+}
+
+void tile_layer::set(size_t idx, uint32_t gid) {
+    if(idx >= _size) {
+        throw out_of_range("tile_layer set out of bounds");
+    }
+
+    if(_index_bytes == 1 || _index_bytes == 2) {
+        auto it = find(begin(_palette), end(_palette), gid);
+        if(it != end(_palette)) {
+            auto const palette_idx = static_cast<uint32_t>(distance(begin(_palette), it));
+            if(_index_bytes == 1) {
+                _indices[idx] = static_cast<uint8_t>(palette_idx);
+            } else {
+                auto const idx16 = static_cast<uint16_t>(palette_idx);
+                memcpy(&_indices[idx * 2], &idx16, sizeof(idx16));
+            }
+            return;
+        }
+    } else if(_index_bytes == 4) {
+        memcpy(&_indices[idx * 4], &gid, sizeof(gid));
+        return;
+    } else if(!_palette.empty() && _palette[0] == gid) {
+        // constant layer that already is this gid
+        return;
+    }
+
+    // new gid or constant layer, happens rarely enough to just rebuild
+    auto gids = decode();
+    gids[idx] = gid;
+    *this = tile_layer(gids);
+}
+
+vector<uint32_t> tile_layer::decode() const {
+    vector<uint32_t> gids;
+    gids.reserve(_size);
+    for(size_t i = 0; i < _size; i++) {
+        gids.push_back((*this)[i]);
+    }
+    return gids;
+}
+
+size_t tile_layer::memory_usage() const noexcept {
+    return sizeof(*this) + _palette.capacity() * sizeof(uint32_t) + _indices.capacity();
+}
@@ -0,0 +1,82 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+using namespace std;
+
+namespace lotr {
+    // Palette compressed gids of a tile layer. Most layers only use a handful of distinct gids, so every tile stores an
+    // 8 or 16 bit index into the palette instead of the gid itself. Layers with a single gid store no indices at all and layers
+    // with more than 65536 distinct gids fall back to the raw gids.
+    class tile_layer {
+    public:
+        tile_layer() noexcept;
+        explicit tile_layer(vector<uint32_t> const &gids);
+
+        [[nodiscard]] uint32_t operator[](size_t idx) const noexcept {
+            switch(_index_bytes) {
+                case 0:
+                    // an empty layer has no palette either, 0 is tiled's empty tile
+                    return _palette.empty() ? 0U : _palette[0];
+                case 1:
+                    return _palette[_indices[idx]];
+                case 2: {
+                    uint16_t i;
+                    memcpy(&i, &_indices[idx * 2], sizeof(i));
+                    return _palette[i];
+                }
+                default: {
+                    uint32_t gid;
+                    memcpy(&gid, &_indices[idx * 4], sizeof(gid));
+                    return gid;
+                }
+            }
+        }
+
+        // rebuilds the layer when gid doesn't fit in the current palette, throws out_of_range if idx is not a tile of this layer
+        void set(size_t idx, uint32_t gid);
+
+        [[nodiscard]] vector<uint32_t> decode() const;
+
+        [[nodiscard]] size_t size() const noexcept {
+            return _size;
+        }
+
+        [[nodiscard]] bool empty() const noexcept {
+            return _size == 0;
+        }
+
+        [[nodiscard]] uint32_t index_bytes() const noexcept {
+            return _index_bytes;
+        }
+
+        [[nodiscard]] size_t memory_usage() const noexcept;
+
+    private:
+        size_t _size;
+        uint32_t _index_bytes;
+        vector<uint32_t> _palette;
+        vector<uint8_t> _indices;
+    };
+}
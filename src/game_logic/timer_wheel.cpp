@@ -0,0 +1,163 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "timer_wheel.h"
+
+using namespace std;
+using namespace lotr;
+
+timer_wheel::timer_wheel() : _buckets(), _nodes(), _free_nodes(), _firing(), _keys(), _current_tick(0), _size(0) {
+    _buckets.fill(no_node);
+}
+
+void timer_wheel::schedule(entt::entity entity, timer_kind kind, uint64_t due_tick) {
+    if(due_tick <= _current_tick) {
+        due_tick = _current_tick + 1;
+    }
+
+    auto it = _keys.find(key_of(entity, kind));
+    if(it != end(_keys)) {
+        auto &node = _nodes[it->second];
+        if(!node.firing) {
+            unlink(it->second);
+            node.due_tick = due_tick;
+            link(it->second);
+            return;
+        }
+
+        // waiting to fire this tick, replaced by the new timer
+        node.cancelled = true;
+        _size--;
+    }
+
+    uint32_t idx;
+    if(_free_nodes.empty()) {
+        idx = _nodes.size();
+        _nodes.emplace_back(entity, kind, due_tick);
+    } else {
+        idx = _free_nodes.back();
+        _free_nodes.pop_back();
+        _nodes[idx] = timer_node(entity, kind, due_tick);
+    }
+
+    _keys[key_of(entity, kind)] = idx;
+    link(idx);
+    _size++;
+}
+
+bool timer_wheel::cancel(entt::entity entity, timer_kind kind) {
+    auto it = _keys.find(key_of(entity, kind));
+    if(it == end(_keys)) {
+        return false;
+    }
+
+    auto const idx = it->second;
+    _keys.erase(it);
+    _size--;
+
+    if(_nodes[idx].firing) {
+        _nodes[idx].cancelled = true;
+    } else {
+        unlink(idx);
+        free_node(idx);
+    }
+
+    return true;
+}
+
+void timer_wheel::cancel_all(entt::entity entity) {
+    for(uint32_t kind = 0; kind < TimerKindCount; kind++) {
+        cancel(entity, static_cast<timer_kind>(kind));
+    }
+}
+
+bool timer_wheel::is_scheduled(entt::entity entity, timer_kind kind) const {
+    return _keys.find(key_of(entity, kind)) != end(_keys);
+}
+
+uint64_t timer_wheel::current_tick() const noexcept {
+    return _current_tick;
+}
+
+uint32_t timer_wheel::size() const noexcept {
+    return _size;
+}
+
+uint32_t timer_wheel::bucket_of(uint64_t due_tick) const noexcept {
+    auto const diff = due_tick ^ _current_tick;
+    for(uint32_t level = 0; level < level_count; level++) {
+        if((diff >> (level_shift * (level + 1))) == 0) {
+            return level * slot_count + ((due_tick >> (level_shift * level)) & (slot_count - 1));
+        }
+    }
+
+    return far_bucket;
+}
+
+void timer_wheel::link(uint32_t idx) noexcept {
+    auto &node = _nodes[idx];
+    node.bucket = bucket_of(node.due_tick);
+    node.prev = no_node;
+    node.next = _buckets[node.bucket];
+
+    if(node.next != no_node) {
+        _nodes[node.next].prev = idx;
+    }
+    _buckets[node.bucket] = idx;
+}
+
+void timer_wheel::unlink(uint32_t idx) noexcept {
+    auto &node = _nodes[idx];
+
+    if(node.prev != no_node) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _buckets[node.bucket] = node.next;
+    }
+
+    if(node.next != no_node) {
+        _nodes[node.next].prev = node.prev;
+    }
+}
+
+void timer_wheel::free_node(uint32_t idx) {
+    _free_nodes.push_back(idx);
+}
+
+void timer_wheel::cascade() {
+    if((_current_tick & (wheel_span - 1)) == 0) {
+        rebucket(far_bucket);
+    }
+
+    for(uint32_t level = level_count - 1; level > 0; level--) {
+        if((_current_tick & ((1ULL << (level_shift * level)) - 1)) == 0) {
+            rebucket(level * slot_count + ((_current_tick >> (level_shift * level)) & (slot_count - 1)));
+        }
+    }
+}
+
+void timer_wheel::rebucket(uint32_t bucket) noexcept {
+    auto idx = _buckets[bucket];
+    _buckets[bucket] = no_node;
+
+    while(idx != no_node) {
+        auto const next = _nodes[idx].next;
+        link(idx);
+        idx = next;
+    }
+}
@@ -0,0 +1,143 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <entt/entity/registry.hpp>
+#include <lotr_flat_map.h>
+
+using namespace std;
+
+namespace lotr {
+    // what a timer is for, an entity has at most one timer of each kind
+    enum timer_kind : uint8_t {
+        RespawnTimer = 0,
+        AiTimer,
+        TimerKindCount
+    };
+
+    // Hierarchical timing wheel, level k buckets timers by bits [k * level_shift, (k + 1) * level_shift) of their due tick.
+    // Timers move down a level when the current tick enters their bucket, so advancing a tick only touches the timers due then
+    // plus the occasional cascade. Timers are keyed by entity and kind, scheduling an existing key moves its timer.
+    class timer_wheel {
+    public:
+        static constexpr uint32_t level_shift = 6;
+        static constexpr uint32_t slot_count = 1U << level_shift;
+        static constexpr uint32_t level_count = 4;
+        // timers further out than this wait in a separate list until the top level comes around
+        static constexpr uint64_t wheel_span = 1ULL << (level_shift * level_count);
+
+        timer_wheel();
+
+        // due ticks that already passed fire on the next advance
+        void schedule(entt::entity entity, timer_kind kind, uint64_t due_tick);
+        // returns false if there was no such timer
+        bool cancel(entt::entity entity, timer_kind kind);
+        void cancel_all(entt::entity entity);
+
+        [[nodiscard]] bool is_scheduled(entt::entity entity, timer_kind kind) const;
+        [[nodiscard]] uint64_t current_tick() const noexcept;
+        [[nodiscard]] uint32_t size() const noexcept;
+
+        // calls f(kind, entity) for every timer due at or before now, in order of due tick.
+        // f may schedule and cancel, timers cancelled or moved by f before their turn don't fire.
+        template <typename Func>
+        void advance(uint64_t now, Func &&f) {
+            while(_current_tick < now) {
+                if(_size == 0) {
+                    _current_tick = now;
+                    return;
+                }
+
+                _current_tick++;
+                cascade();
+
+                auto &head = _buckets[_current_tick & (slot_count - 1)];
+                for(auto idx = head; idx != no_node; idx = _nodes[idx].next) {
+                    _nodes[idx].firing = true;
+                    _firing.push_back(idx);
+                }
+                head = no_node;
+
+                for(auto idx : _firing) {
+                    if(_nodes[idx].cancelled) {
+                        continue;
+                    }
+
+                    auto const entity = _nodes[idx].entity;
+                    auto const kind = _nodes[idx].kind;
+                    _keys.erase(key_of(entity, kind));
+                    _size--;
+                    _nodes[idx].cancelled = true;
+                    f(kind, entity);
+                }
+
+                for(auto idx : _firing) {
+                    free_node(idx);
+                }
+                _firing.clear();
+            }
+        }
+
+    private:
+        static constexpr uint32_t no_node = ~0U;
+
+        struct timer_node {
+            entt::entity entity;
+            timer_kind kind;
+            // taken off its list to fire this tick, the node is freed once all of them ran
+            bool firing;
+            // fired already, or cancelled while waiting to fire
+            bool cancelled;
+            uint64_t due_tick;
+            uint32_t bucket;
+            uint32_t prev;
+            uint32_t next;
+
+            timer_node(entt::entity entity, timer_kind kind, uint64_t due_tick) noexcept : entity(entity), kind(kind), firing(false), cancelled(false), due_tick(due_tick),
+                bucket(0), prev(no_node), next(no_node) {}
+        };
+
+        [[nodiscard]] static uint64_t key_of(entt::entity entity, timer_kind kind) noexcept {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(entity)) << 8U) | kind;
+        }
+
+        // level * slot_count + slot, or far_bucket
+        [[nodiscard]] uint32_t bucket_of(uint64_t due_tick) const noexcept;
+        void link(uint32_t idx) noexcept;
+        void unlink(uint32_t idx) noexcept;
+        void free_node(uint32_t idx);
+        // re-buckets the timers of the higher level slots the current tick just entered
+        void cascade();
+        void rebucket(uint32_t bucket) noexcept;
+
+        static constexpr uint32_t far_bucket = level_count * slot_count;
+
+        // heads of intrusive doubly linked lists through _nodes
+        array<uint32_t, far_bucket + 1> _buckets;
+        vector<timer_node> _nodes;
+        vector<uint32_t> _free_nodes;
+        vector<uint32_t> _firing;
+        lotr_flat_map<uint64_t, uint32_t> _keys;
+        uint64_t _current_tick;
+        uint32_t _size;
+    };
+}
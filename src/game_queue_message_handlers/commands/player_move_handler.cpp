@@ -20,43 +20,29 @@
 
 #include <spdlog/spdlog.h>
 #include <ecs/components.h>
-#include <range/v3/view/filter.hpp>
 #include <messages/generic_error_response.h>
 #include <game_logic/logic_helpers.h>
 
 using namespace std;
 
 namespace lotr {
-    void handle_player_move_message(queue_message* msg, entt::registry& registry, outward_queues& outward_queue) {
-        auto *move_msg = dynamic_cast<player_move_message*>(msg);
+    void handle_player_move_message(player_move_message const &move_msg, entt::registry& registry, outward_queues& outward_queue) {
+        spdlog::trace("[{}] conn {} move to {} {}", __FUNCTION__, move_msg.x, move_msg.y, move_msg.connection_id);
 
-        if(move_msg == nullptr) {
-            spdlog::error("[{}] player_move_message nullptr", __FUNCTION__);
+        auto handle = find_player_by_connection(registry, move_msg.connection_id);
+        if(!handle) {
             return;
         }
 
-        spdlog::trace("[{}] conn {} move to {} {}", __FUNCTION__, move_msg->x, move_msg->y, move_msg->connection_id);
-
-        auto map_view = registry.view<map_component>();
-
-        for(auto m_entity : map_view) {
-            map_component &m = map_view.get(m_entity);
-            auto player = m.players | ranges::views::remove_if([&](pc_component const &pc){ return pc.connection_id != move_msg->connection_id; });
-
-            if(player.empty()) {
-                continue;
-            }
-
-            if(move_msg->x >= m.width || move_msg->y >= m.height || !tile_is_walkable(m, move_msg->x, move_msg->y)) {
-                spdlog::error("[{}] wrong coordinates {} {} {} {}", __FUNCTION__, m.name, move_msg->x, move_msg->y, move_msg->connection_id);
-                outward_queue.enqueue(outward_message{move_msg->connection_id, make_unique<generic_error_response>("Wrong coordinates", "Wrong coordinates", "Wrong coordinates", true)});
-                return;
-            }
+        auto &m = *handle->m;
+        if(move_msg.x >= m.width || move_msg.y >= m.height || !tile_is_walkable(m, move_msg.x, move_msg.y)) {
+            spdlog::error("[{}] wrong coordinates {} {} {} {}", __FUNCTION__, m.name, move_msg.x, move_msg.y, move_msg.connection_id);
+            outward_queue.enqueue(outward_message{move_msg.connection_id, make_unique<generic_error_response>("Wrong coordinates", "Wrong coordinates", "Wrong coordinates", true)});
+            return;
+        }
 
-            player.back().loc = make_tuple(move_msg->x, move_msg->y);
+        move_player(m, handle->entity, make_tuple(move_msg.x, move_msg.y));
 
-            spdlog::info("[{}] conn {} character {} moved to {} {}", __FUNCTION__, move_msg->connection_id, player.back().name, move_msg->x, move_msg->y);
-            break;
-        }
+        spdlog::info("[{}] conn {} character {} moved to {} {}", __FUNCTION__, move_msg.connection_id, m.entities.get<appearance_component>(handle->entity).name, move_msg.x, move_msg.y);
     }
 }
@@ -24,5 +24,5 @@
 using namespace std;
 
 namespace lotr {
-    void handle_player_move_message(queue_message*, entt::registry&, outward_queues&);
+    void handle_player_move_message(player_move_message const &, entt::registry&, outward_queues&);
 }
@@ -0,0 +1,37 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "player_resync_handler.h"
+
+#include <spdlog/spdlog.h>
+#include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
+
+using namespace std;
+
+namespace lotr {
+    void handle_player_resync_message(player_resync_message const &resync_msg, entt::registry& registry, outward_queues&) {
+        auto handle = find_player_by_connection(registry, resync_msg.connection_id);
+        if(!handle) {
+            return;
+        }
+
+        handle->m->entities.get<connection_component>(handle->entity).keyframe_requested = true;
+        spdlog::debug("[{}] conn {} requested resync", __FUNCTION__, resync_msg.connection_id);
+    }
+}
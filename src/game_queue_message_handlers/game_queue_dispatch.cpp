@@ -0,0 +1,46 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "game_queue_dispatch.h"
+
+#include <type_traits>
+#include "player_enter_handler.h"
+#include "player_leave_handler.h"
+#include "commands/player_move_handler.h"
+#include "commands/player_resync_handler.h"
+
+using namespace std;
+
+namespace lotr {
+    void dispatch_game_queue_message(queue_message const &msg, entt::registry &registry, outward_queues &outward_queue) {
+        visit([&](auto const &typed_msg) {
+            using T = decay_t<decltype(typed_msg)>;
+            if constexpr (is_same_v<T, player_enter_message>) {
+                handle_player_enter_message(typed_msg, registry, outward_queue);
+            } else if constexpr (is_same_v<T, player_leave_message>) {
+                handle_player_leave_message(typed_msg, registry, outward_queue);
+            } else if constexpr (is_same_v<T, player_move_message>) {
+                handle_player_move_message(typed_msg, registry, outward_queue);
+            } else if constexpr (is_same_v<T, player_resync_message>) {
+                handle_player_resync_message(typed_msg, registry, outward_queue);
+            } else {
+                static_assert(!is_same_v<T, T>, "game queue message without handler");
+            }
+        }, msg);
+    }
+}
@@ -0,0 +1,29 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <game_queue_messages/messages.h>
+#include <entt/entt.hpp>
+
+using namespace std;
+
+namespace lotr {
+    // calls the handler for the message type the variant holds
+    void dispatch_game_queue_message(queue_message const &msg, entt::registry &registry, outward_queues &outward_queue);
+}
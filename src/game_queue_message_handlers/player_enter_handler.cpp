@@ -20,64 +20,52 @@
 
 #include <spdlog/spdlog.h>
 #include <ecs/components.h>
-#include <range/v3/algorithm/any_of.hpp>
 #include <messages/generic_error_response.h>
+#include <game_logic/logic_helpers.h>
 
 using namespace std;
 
 namespace lotr {
-    void handle_player_enter_message(queue_message* msg, entt::registry& registry, outward_queues& outward_queue) {
-        auto *enter_msg = dynamic_cast<player_enter_message*>(msg);
+    void handle_player_enter_message(player_enter_message const &enter_msg, entt::registry& registry, outward_queues& outward_queue) {
+        spdlog::trace("[{}] {} {} {}", __FUNCTION__, enter_msg.map_name, enter_msg.x, enter_msg.y);
 
-        if(enter_msg == nullptr) {
-            spdlog::error("[{}] player_enter_message nullptr", __FUNCTION__);
+        if(find_player_by_name(registry, enter_msg.character_name)) {
+            spdlog::warn("[{}] character already in game {} {}", __FUNCTION__, enter_msg.character_name, enter_msg.connection_id);
+            outward_queue.enqueue(outward_message{enter_msg.connection_id, make_unique<generic_error_response>("already playing that character", "already playing that character", "already playing that character", true)});
             return;
         }
 
-        spdlog::trace("[{}] {} {} {}", __FUNCTION__, enter_msg->map_name, enter_msg->x, enter_msg->y);
-
         auto map_view = registry.view<map_component>();
-
-        for(auto m_entity : map_view) {
-            map_component const &m = map_view.get(m_entity);
-
-            if(ranges::any_of(m.players, [&](pc_component const &pc){ return pc.name == enter_msg->character_name; })) {
-                spdlog::warn("[{}] character already in game {} {}", __FUNCTION__, enter_msg->character_name, enter_msg->connection_id);
-                outward_queue.enqueue(outward_message{enter_msg->connection_id, make_unique<generic_error_response>("already playing that character", "already playing that character", "already playing that character", true)});
-                return;
-            }
-        }
-
         for(auto m_entity : map_view) {
             map_component &m = map_view.get(m_entity);
 
-            if(m.name != enter_msg->map_name) {
+            if(m.name != enter_msg.map_name) {
                 continue;
             }
 
-            if(enter_msg->x >= m.width || enter_msg->y >= m.height) {
-                spdlog::error("[{}] wrong coordinates {} {} {} {}", __FUNCTION__, enter_msg->map_name, enter_msg->x, enter_msg->y, enter_msg->connection_id);
-                outward_queue.enqueue(outward_message{enter_msg->connection_id, make_unique<generic_error_response>("Wrong coordinates", "Wrong coordinates", "Wrong coordinates", true)});
+            if(enter_msg.x >= m.width || enter_msg.y >= m.height) {
+                spdlog::error("[{}] wrong coordinates {} {} {} {}", __FUNCTION__, enter_msg.map_name, enter_msg.x, enter_msg.y, enter_msg.connection_id);
+                outward_queue.enqueue(outward_message{enter_msg.connection_id, make_unique<generic_error_response>("Wrong coordinates", "Wrong coordinates", "Wrong coordinates", true)});
                 return;
             }
 
             pc_component pc{};
-            pc.name = enter_msg->character_name;
-            pc.level = enter_msg->level;
-            pc.gold = enter_msg->gold;
-            pc.loc = make_tuple(enter_msg->x, enter_msg->y);
-            pc.connection_id = enter_msg->connection_id;
-            pc.gender = enter_msg->gender;
-            pc.allegiance = enter_msg->allegiance;
-            pc.character_class = enter_msg->baseclass;
-
-            for(auto &stat : enter_msg->player_stats) {
-                pc.stats[stat.name] = stat.value;
+            pc.level = enter_msg.level;
+            pc.gold = enter_msg.gold;
+            pc.gender = interned_string(enter_msg.gender);
+            pc.allegiance = interned_string(enter_msg.allegiance);
+            pc.character_class = interned_string(enter_msg.baseclass);
+
+            for(auto &stat : enter_msg.player_stats) {
+                if(auto id = stat_id_from_name(stat.name)) {
+                    pc.stats[*id] = stat.value;
+                }
             }
 
-            m.players.emplace_back(pc);
+            add_player_to_game(registry, m_entity, make_tuple(enter_msg.x, enter_msg.y), appearance_component(npc_id_counter++, enter_msg.character_name, 0),
+                               enter_msg.connection_id, move(pc));
 
-            spdlog::info("[{}] character {} entered game {}", __FUNCTION__, pc.name, enter_msg->connection_id);
+            spdlog::info("[{}] character {} entered game {}", __FUNCTION__, enter_msg.character_name, enter_msg.connection_id);
             break;
         }
     }
@@ -20,29 +20,18 @@
 
 #include <spdlog/spdlog.h>
 #include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
 
 using namespace std;
 
 namespace lotr {
-    void handle_player_leave_message(queue_message* msg, entt::registry& registry, outward_queues&) {
-        auto *leave_message = dynamic_cast<player_leave_message*>(msg);
-
-        if(leave_message == nullptr) {
-            spdlog::error("[{}] player_leave_message nullptr", __FUNCTION__);
+    void handle_player_leave_message(player_leave_message const &leave_message, entt::registry& registry, outward_queues&) {
+        auto handle = find_player_by_connection(registry, leave_message.connection_id);
+        if(!handle) {
             return;
         }
 
-        auto map_view = registry.view<map_component>();
-
-        for(auto m_entity : map_view) {
-            map_component &m = map_view.get(m_entity);
-            m.players.erase(remove_if(begin(m.players), end(m.players), [&leave_message](pc_component const &pc) {
-                if(pc.connection_id == leave_message->connection_id) {
-                    spdlog::info("[handle_player_leave_message] character {} left game {}", pc.name, pc.connection_id);
-                    return true;
-                }
-                return false;
-            }), end(m.players));
-        }
+        spdlog::info("[{}] character {} left game {}", __FUNCTION__, handle->m->entities.get<appearance_component>(handle->entity).name, leave_message.connection_id);
+        remove_player_from_game(registry, *handle);
     }
 }
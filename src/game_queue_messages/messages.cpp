@@ -20,17 +20,16 @@
 #include <ecs/components.h>
 
 namespace lotr {
-    uint32_t const player_enter_message::_type = 1;
-    uint32_t const player_leave_message::_type = 2;
-    uint32_t const player_move_message::_type  = 3;
-
     player_enter_message::player_enter_message(string character_name, string gender, string allegiance, string baseclass, string map_name, vector <stat_component> player_stats, uint64_t connection_id, uint32_t level, uint32_t gold, uint32_t x, uint32_t y)
-            : queue_message(_type, connection_id), character_name(move(character_name)), gender(move(gender)), allegiance(move(allegiance)), baseclass(move(baseclass)),
+            : connection_id(connection_id), character_name(move(character_name)), gender(move(gender)), allegiance(move(allegiance)), baseclass(move(baseclass)),
             map_name(move(map_name)), player_stats(move(player_stats)), level(level), gold(gold), x(x), y(y) {}
 
-    player_leave_message::player_leave_message(uint64_t connection_id)
-            : queue_message(_type, connection_id) {}
+    player_leave_message::player_leave_message(uint64_t connection_id) noexcept
+            : connection_id(connection_id) {}
+
+    player_move_message::player_move_message(uint64_t connection_id, uint32_t x, uint32_t y) noexcept
+            : connection_id(connection_id), x(x), y(y) {}
 
-    player_move_message::player_move_message(uint64_t connection_id, uint32_t x, uint32_t y)
-            : queue_message(_type, connection_id), x(x), y(y) {}
+    player_resync_message::player_resync_message(uint64_t connection_id) noexcept
+            : connection_id(connection_id) {}
 }
@@ -20,6 +20,7 @@
 
 #include <string>
 #include <vector>
+#include <variant>
 #include <lotr_flat_map.h>
 #include <concurrentqueue.h>
 #include <messages/message.h>
@@ -30,15 +31,10 @@ namespace lotr {
     struct stat_component;
     using outward_queues = moodycamel::ConcurrentQueue<outward_message>;
 
-    struct queue_message {
-        uint32_t type;
+    // Messages from the websocket threads to the game loop. They're stored by value in the queue, so enqueueing a
+    // message without strings or vectors does not allocate, and dispatch is a std::visit instead of a map lookup and a cast.
+    struct player_enter_message {
         uint64_t connection_id;
-
-        queue_message(uint32_t type, uint64_t connection_id) : type(type), connection_id(connection_id) {}
-        virtual ~queue_message() {}
-    };
-
-    struct player_enter_message : queue_message {
         string character_name;
         string gender;
         string allegiance;
@@ -49,22 +45,29 @@ namespace lotr {
         uint32_t gold;
         uint32_t x;
         uint32_t y;
-        static uint32_t const _type;
 
         player_enter_message(string character_name, string gender, string allegiance, string baseclass, string map_name, vector<stat_component> player_stats, uint64_t connection_id, uint32_t level, uint32_t gold, uint32_t x, uint32_t y);
     };
 
-    struct player_leave_message : queue_message {
-        static uint32_t const _type;
+    struct player_leave_message {
+        uint64_t connection_id;
 
-        explicit player_leave_message(uint64_t connection_id);
+        explicit player_leave_message(uint64_t connection_id) noexcept;
     };
 
-    struct player_move_message : queue_message {
-        static uint32_t const _type;
+    struct player_move_message {
+        uint64_t connection_id;
         uint32_t x;
         uint32_t y;
 
-        player_move_message(uint64_t connection_id, uint32_t x, uint32_t y);
+        player_move_message(uint64_t connection_id, uint32_t x, uint32_t y) noexcept;
     };
+
+    struct player_resync_message {
+        uint64_t connection_id;
+
+        explicit player_resync_message(uint64_t connection_id) noexcept;
+    };
+
+    using queue_message = variant<player_enter_message, player_leave_message, player_move_message, player_resync_message>;
 }
@@ -28,12 +28,11 @@
 #include <asset_loading/load_assets.h>
 #include <game_logic/logic_helpers.h>
 #include <sodium.h>
-#include <messages/map_update_response.h>
-#include <game_queue_message_handlers/player_enter_handler.h>
-#include <game_queue_message_handlers/player_leave_handler.h>
-#include <game_queue_message_handlers/commands/player_move_handler.h>
-#include <range/v3/all.hpp>
+#include <game_queue_message_handlers/game_queue_dispatch.h>
 #include <asset_loading/load_character_select.h>
+#include <game_logic/map_tick.h>
+#include <metrics/tick_profiler.h>
+#include <messages/batch_response.h>
 
 #include "config.h"
 #include "logger_init.h"
@@ -43,9 +42,11 @@
 #include "repositories/banned_users_repository.h"
 #include "repositories/characters_repository.h"
 #include "working_directory_manipulation.h"
+#include "work_stealing_pool.h"
+#include "send_pipeline.h"
 
-#include "ai/default_ai.h"
 #include "uws_thread.h"
+#include "tick_clock.h"
 using namespace std;
 using namespace lotr;
 
@@ -95,7 +96,12 @@ int main() {
 
     entt::registry registry;
 
-    load_assets(registry, quit);
+    load_assets(registry, config.tick_length, quit);
+
+    if(config.precompute_fov) {
+        load_fov_tables(registry, quit);
+    }
+
     auto char_sel = load_character_select();
 
     if(!char_sel) {
@@ -110,113 +116,150 @@ int main() {
     }
 
     auto uws_thread = run_uws(config, pool, s_handle, quit);
+    if(config.io_thread_cpu >= 0) {
+        pin_thread_to_cpu(uws_thread, config.io_thread_cpu);
+    }
+    if(config.game_thread_cpu >= 0) {
+        pin_current_thread_to_cpu(config.game_thread_cpu);
+    }
 
     outward_queues outward_queue;
-    vector<uint64_t> frame_times;
-    auto next_tick = chrono::system_clock::now() + chrono::milliseconds(config.tick_length);
-    auto next_log_tick_times = chrono::system_clock::now() + chrono::seconds(1);
-    uint32_t tick_counter = 0;
-
-    lotr_flat_map<uint32_t, function<void(queue_message*, entt::registry&, outward_queues&)>> game_queue_message_router;
-    game_queue_message_router.emplace(player_enter_message::_type, handle_player_enter_message);
-    game_queue_message_router.emplace(player_leave_message::_type, handle_player_leave_message);
-    game_queue_message_router.emplace(player_move_message::_type, handle_player_move_message);
-
-    while (!quit) {
-        auto now = chrono::system_clock::now();
-        if(now < next_tick) {
-            this_thread::sleep_until(next_tick);
+    tick_clock clock(chrono::milliseconds(config.tick_length), chrono::microseconds(config.tick_spin_us));
+    auto next_log_tick_times = chrono::steady_clock::now() + chrono::seconds(config.tick_profile_interval);
+
+    moodycamel::ConsumerToken game_loop_token(game_loop_queue);
+    vector<queue_message> game_messages;
+
+    vector<map_component*> maps;
+    auto map_view = registry.view<map_component>();
+    for(auto m_entity : map_view) {
+        auto &m = map_view.get(m_entity);
+        m.ai_full_radius = config.ai_full_radius;
+        m.dormant_interval = config.dormant_map_interval;
+        maps.push_back(&m);
+    }
+    vector<vector<outward_message>> map_outboxes(maps.size());
+    vector<outward_message> pending_sends;
+    // serializing and writing to sockets happens on the sender threads, while the game loop continues with the next tick
+    send_pipeline sender(config.sender_threads, [&](vector<outward_message> &messages) {
+        coalesce_by_connection(messages);
+
+        shared_lock lock(user_connections_mutex);
+        for(auto &msg : messages) {
+            auto user_data = user_connections.find(msg.conn_id);
+            if (user_data != end(user_connections) && !user_data->second.ws.expired()) {
+                try {
+                    // websocketpp sends don't block, a client that doesn't read its socket fast enough grows this buffer instead
+                    auto con = s_handle.s->get_con_from_hdl(user_data->second.ws);
+                    if(con->get_buffered_amount() > config.max_send_buffer_bytes) {
+                        spdlog::warn("[{}] connection {} has {} unsent bytes, disconnecting", __FUNCTION__, msg.conn_id, con->get_buffered_amount());
+                        con->close(websocketpp::close::status::policy_violation, "Not keeping up with messages");
+                        continue;
+                    }
+                    send_message(s_handle.s, user_data->second, *msg.msg);
+                } catch (...) {
+                    continue;
+                }
+            } else {
+                spdlog::warn("[{}] couldn't find connection id {}, wanted to send outward message", __FUNCTION__, msg.conn_id);
+                game_loop_queue.enqueue(player_leave_message(msg.conn_id));
+            }
         }
-        auto tick_start = chrono::system_clock::now();
-
-        auto map_view = registry.view<map_component>();
-
-        {
-            unique_ptr<queue_message> msg(nullptr);
-            while (game_loop_queue.try_dequeue(msg)) {
-                spdlog::trace("[{}] got game loop msg with type {}", __FUNCTION__, msg->type);
-                game_queue_message_router[msg->type](msg.get(), registry, outward_queue);
+    }, config.max_pending_per_connection, [&](uint64_t conn_id) {
+        // the sender threads fell behind on this connection's messages, on_close takes care of the player leaving
+        shared_lock lock(user_connections_mutex);
+        auto user_data = user_connections.find(conn_id);
+        if (user_data != end(user_connections) && !user_data->second.ws.expired()) {
+            try {
+                s_handle.s->close(user_data->second.ws, websocketpp::close::status::policy_violation, "Too many pending messages");
+            } catch (...) {
             }
         }
+    });
+    vector<tick_phase_timings> map_timings(maps.size());
 
+    vector<string> map_names;
+    for(auto *m : maps) {
+        map_names.push_back(m->name);
+    }
+    tick_profiler profiler(move(map_names));
 
-        for(auto m_entity : map_view) {
-            map_component &m = map_view.get(m_entity);
-            lotr_player_location_map player_location_map;
-
-            for (auto &player : m.players) {
-                auto existing_players = player_location_map.find(player.loc);
-
-                if (existing_players == end(player_location_map)) {
-                    player_location_map[player.loc] = vector<pc_component *>{&player};
-                } else {
-                    existing_players->second.push_back(&player);
-                }
-
-                player.fov = compute_fov_restrictive_shadowcasting(m, player.loc, true);
-
-                auto min_x = max(0U, get<0>(player.loc) - fov_max_distance);
-                auto min_y = max(0U, get<1>(player.loc) - fov_max_distance);
-                auto max_x = min(m.width, get<0>(player.loc) + fov_max_distance);
-                auto max_y = min(m.height, get<1>(player.loc) + fov_max_distance);
-
-                auto visible_npcs = m.npcs | ranges::views::filter([&](npc_component const &npc){ return is_visible(player.loc, npc.loc, player.fov, min_x, max_x, min_y, max_y); });
-                auto visible_pcs = m.players | ranges::views::filter([&](pc_component const &pc){ return is_visible(player.loc, pc.loc, player.fov, min_x, max_x, min_y, max_y) && player.connection_id != pc.connection_id; });
-                vector<character_component> cs;
-
-                for(auto &npc : visible_npcs) {
-                    cs.push_back(npc);
-                }
+    unique_ptr<work_stealing_pool> tick_pool;
+    if(config.tick_threads > 1) {
+        tick_pool = make_unique<work_stealing_pool>(config.tick_threads - 1);
+        spdlog::info("[{}] ticking {} maps on {} threads", __FUNCTION__, maps.size(), config.tick_threads);
+    }
 
-                for(auto &pc : visible_pcs) {
-                    cs.push_back(pc);
-                }
+    while (!quit) {
+        auto const lateness = clock.wait_for_next_tick();
+        auto tick_start = chrono::steady_clock::now();
+        tick_phase_timings tick_timings{};
+        tick_timings[Jitter] = lateness.count();
 
-                outward_queue.enqueue(outward_message{player.connection_id, make_unique<map_update_response>(cs)});
+        {
+            while (game_loop_queue.try_dequeue_bulk(game_loop_token, back_inserter(game_messages), 256) > 0) {}
+            for(auto const &msg : game_messages) {
+                spdlog::trace("[{}] got game loop msg with type {}", __FUNCTION__, msg.index());
+                dispatch_game_queue_message(msg, registry, outward_queue);
             }
+            game_messages.clear();
+        }
+        tick_timings[QueueDrain] = elapsed_ns(tick_start);
+
+        // past this, respawns and npc ai continue next tick, so map updates and sends stay on time
+        auto const deadline = config.tick_budget_percent == 0 ? chrono::steady_clock::time_point::max() :
+                              tick_start + chrono::microseconds(config.tick_length * 10 * config.tick_budget_percent);
+        if(tick_pool) {
+            tick_pool->run_and_wait(maps.size(), [&](uint32_t i) { tick_map(*maps[i], registry, map_outboxes[i], config.map_keyframe_interval, deadline, map_timings[i]); });
+        } else {
+            for(uint32_t i = 0; i < maps.size(); i++) {
+                tick_map(*maps[i], registry, map_outboxes[i], config.map_keyframe_interval, deadline, map_timings[i]);
+            }
+        }
 
-            remove_dead_npcs(m.npcs);
-            fill_spawners(m, m.npcs, registry);
+        // merge in map order, so the outward queue does not depend on which thread finished first
+        for(uint32_t i = 0; i < maps.size(); i++) {
+            auto &outbox = map_outboxes[i];
+            outward_queue.enqueue_bulk(make_move_iterator(begin(outbox)), outbox.size());
+            outbox.clear();
 
-            for(auto &npc : m.npcs) {
-                run_ai_on(npc, m, player_location_map);
+            profiler.record_map_tick(i, map_timings[i]);
+            for(uint32_t phase = Fov; phase <= Ai; phase++) {
+                tick_timings[phase] += map_timings[i][phase];
             }
+            map_timings[i].fill(0);
         }
 
-        auto tick_end = chrono::system_clock::now();
-        frame_times.push_back(chrono::duration_cast<chrono::microseconds>(tick_end - tick_start).count());
-        next_tick += chrono::milliseconds(config.tick_length);
-        tick_counter++;
-
         {
-            outward_message msg{{}, nullptr};
-            while (outward_queue.try_dequeue(msg)) {
-                shared_lock lock(user_connections_mutex);
-                auto user_data = user_connections.find(msg.conn_id);
-                if (user_data != end(user_connections) && !user_data->second.ws.expired()) {
-                    try {
-                        s_handle.s->send(user_data->second.ws, msg.msg->serialize(), websocketpp::frame::opcode::value::TEXT);
-                    } catch (...) {
-                        continue;
-                    }
-                } else {
-                    spdlog::warn("[{}] couldn't find connection id {}, wanted to send outward message", __FUNCTION__, msg.conn_id);
-                    game_loop_queue.enqueue(make_unique<player_leave_message>(msg.conn_id));
-                }
-            }
+            auto send_start = chrono::steady_clock::now();
+            while (outward_queue.try_dequeue_bulk(back_inserter(pending_sends), 256) > 0) {}
+            sender.submit(pending_sends);
+            tick_timings[Send] = elapsed_ns(send_start);
+        }
+
+        tick_timings[Total] = elapsed_ns(tick_start);
+        profiler.record_tick(tick_timings);
+
+        auto tick_end = chrono::steady_clock::now();
+        auto const dropped = clock.advance(tick_end);
+        if(dropped > 0) {
+            spdlog::warn("[{}] tick overran, skipped {} ticks", __FUNCTION__, dropped);
         }
 
         if(config.log_tick_times && tick_end > next_log_tick_times) {
-            spdlog::info("[{}] ticks {} - frame times max/avg/min: {} / {} / {} µs", __FUNCTION__, tick_counter,
-                         *max_element(begin(frame_times), end(frame_times)), accumulate(begin(frame_times), end(frame_times), 0UL) / frame_times.size(),
-                         *min_element(begin(frame_times), end(frame_times)));
-            frame_times.clear();
-            next_log_tick_times += chrono::seconds(1);
-            tick_counter = 0;
+            profiler.publish();
+            for(auto *m : maps) {
+                if(m->deferred_work > 0) {
+                    spdlog::info("[{}] map {} deferred {} respawns and ai actions to a later tick", __FUNCTION__, m->name, m->deferred_work);
+                    m->deferred_work = 0;
+                }
+            }
+            next_log_tick_times += chrono::seconds(config.tick_profile_interval);
         }
     }
 
     spdlog::warn("[{}] quitting program", __FUNCTION__);
+    sender.flush();
     s_handle.s->stop();
     uws_thread.join();
     spdlog::warn("[{}] uws thread stopped", __FUNCTION__);
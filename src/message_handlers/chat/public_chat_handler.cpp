@@ -33,12 +33,14 @@ using namespace chrono;
 namespace lotr {
     template <class Server, class WebSocket>
     void handle_public_chat(Server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool, per_socket_data<WebSocket> *user_data,
-            moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+            moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
         MEASURE_TIME_OF_FUNCTION()
         DESERIALIZE_WITH_LOGIN_CHECK(message_request)
 
         auto now = system_clock::now();
-        auto chat_msg = message_response(user_data->username, sensor.clean_profanity_ish(msg->content), "game", duration_cast<milliseconds>(now.time_since_epoch()).count()).serialize();
+        message_response response(user_data->username, sensor.clean_profanity_ish(msg->content), "game", duration_cast<milliseconds>(now.time_since_epoch()).count());
+        auto chat_msg = response.serialize();
+        auto chat_msg_binary = response.serialize_binary();
 
         {
             shared_lock lock(user_connections_mutex);
@@ -47,7 +49,11 @@ namespace lotr {
                     if (other_user_data.ws.expired()) {
                         continue;
                     }
-                    s->send(other_user_data.ws, chat_msg, websocketpp::frame::opcode::value::TEXT);
+                    if(other_user_data.binary_protocol_version > 0) {
+                        s->send(other_user_data.ws, chat_msg_binary, websocketpp::frame::opcode::value::BINARY);
+                    } else {
+                        s->send(other_user_data.ws, chat_msg, websocketpp::frame::opcode::value::TEXT);
+                    }
                 } catch (...) {
                     continue;
                 }
@@ -56,5 +62,5 @@ namespace lotr {
     }
 
     template void handle_public_chat<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
 }
@@ -29,13 +29,13 @@ using namespace std;
 namespace lotr {
     template <class Server, class WebSocket>
     void handle_move(Server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool, per_socket_data<WebSocket> *user_data,
-            moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+            moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
         MEASURE_TIME_OF_FUNCTION()
         DESERIALIZE_WITH_PLAYING_CHECK(move_request)
 
-        q.enqueue(make_unique<player_move_message>(user_data->connection_id, msg->x, msg->y));
+        q.enqueue(player_move_message(user_data->connection_id, msg->x, msg->y));
     }
 
     template void handle_move<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
 }
@@ -29,5 +29,5 @@ using namespace std;
 namespace lotr {
     template <class Server, class WebSocket>
     void handle_move(Server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-                     per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections);
+                     per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections);
 }
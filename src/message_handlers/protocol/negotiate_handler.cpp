@@ -0,0 +1,58 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "negotiate_handler.h"
+
+#include <spdlog/spdlog.h>
+
+#include <messages/protocol/negotiate_request.h>
+#include <messages/protocol/negotiate_response.h>
+#include "message_handlers/handler_macros.h"
+#include <uws_thread.h>
+
+using namespace std;
+
+namespace lotr {
+    template <class Server, class WebSocket>
+    void handle_negotiate(Server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool, per_socket_data<WebSocket> *user_data,
+            moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+        MEASURE_TIME_OF_FUNCTION()
+        DESERIALIZE_WITH_CHECK(negotiate_request)
+
+        // the reply is always json, the new encoding applies to everything after it
+        bool const binary = msg->encoding == "binary" && msg->version == binary_protocol_version;
+        if(binary) {
+            negotiate_response response("binary", binary_protocol_version, binary_schema);
+            s->send(user_data->ws, response.serialize(), websocketpp::frame::opcode::value::TEXT);
+        } else {
+            negotiate_response response("json", 0, {});
+            s->send(user_data->ws, response.serialize(), websocketpp::frame::opcode::value::TEXT);
+        }
+
+        {
+            // send pipeline workers read the version under a shared lock
+            unique_lock lock(user_connections_mutex);
+            user_data->binary_protocol_version = binary ? binary_protocol_version : 0;
+        }
+
+        spdlog::debug("[{}] conn {} negotiated {} {}", __FUNCTION__, user_data->connection_id, msg->encoding, binary ? binary_protocol_version : 0);
+    }
+
+    template void handle_negotiate<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
+            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+}
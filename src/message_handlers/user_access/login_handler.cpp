@@ -39,7 +39,7 @@ using namespace std;
 namespace lotr {
     template <class Server, class WebSocket>
     void handle_login(Server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-                      per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                      per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
         MEASURE_TIME_OF_FUNCTION()
         DESERIALIZE_WITH_NOT_LOGIN_CHECK(login_request)
 
@@ -121,10 +121,9 @@ namespace lotr {
         }
 
         login_response response(move(message_players), move(online_users), usr->username, usr->email, motd);
-        auto response_msg = response.serialize();
-        s->send(user_data->ws, response_msg, websocketpp::frame::opcode::value::TEXT);
+        send_message(s, *user_data, response);
     }
 
     template void handle_login<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
 }
@@ -19,6 +19,8 @@
 
 #include "play_character_handler.h"
 
+#include <bitset>
+
 #include <spdlog/spdlog.h>
 
 #include <messages/user_access/play_character_request.h>
@@ -36,7 +38,7 @@ using namespace std;
 namespace lotr {
     template <class Server, class WebSocket>
     void handle_play_character(Server *s, rapidjson::Document const &d,
-                         shared_ptr<database_pool> pool, per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
+                         shared_ptr<database_pool> pool, per_socket_data<WebSocket> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<WebSocket>> &user_connections) {
         MEASURE_TIME_OF_FUNCTION()
         DESERIALIZE_WITH_NOT_PLAYING_CHECK(play_character_request)
 
@@ -97,21 +99,24 @@ namespace lotr {
         }
 
         vector<stat_component> player_stats_mods;
-        player_stats_mods.reserve(stat_names.size());
-        for(auto const &stat : stat_names) {
-            auto value = 0;
-            auto allegiance_value_it = find_if(begin(allegiance_it->stat_mods), end(allegiance_it->stat_mods), [&stat](stat_component const &sc){ return sc.name == stat; });
-            auto class_value_it = find_if(begin(classes_it->stat_mods), end(classes_it->stat_mods), [&stat](stat_component const &sc){ return sc.name == stat; });
-
-            if(allegiance_value_it != end(allegiance_it->stat_mods)) {
-                value += allegiance_value_it->value;
-            }
-
-            if(class_value_it != end(classes_it->stat_mods)) {
-                value += class_value_it->value;
+        // first entry per stat wins, the loader can append a second maxHp/maxMp
+        array<int64_t, StatCount> mod_values{};
+        auto add_mods = [&mod_values](vector<stat_component> const &mods) {
+            bitset<StatCount> seen;
+            for(auto const &sc : mods) {
+                auto id = stat_id_from_name(sc.name);
+                if(id && !seen[*id]) {
+                    seen.set(*id);
+                    mod_values[*id] += sc.value;
+                }
             }
+        };
+        add_mods(allegiance_it->stat_mods);
+        add_mods(classes_it->stat_mods);
 
-            player_stats_mods.emplace_back(stat, value);
+        player_stats_mods.reserve(StatCount);
+        for(uint32_t i = 0; i < StatCount; i++) {
+            player_stats_mods.emplace_back(string(stat_name_table[i]), mod_values[i]);
         }
 
         vector<stat_component> player_stats;
@@ -121,10 +126,10 @@ namespace lotr {
         }
         spdlog::debug("[{}] enqueing character {} slot {}", __FUNCTION__, character->name, character->slot);
         spdlog::trace("[{}] enqueing character {} has loc {}", __FUNCTION__, character->name, character->loc.has_value());
-        q.enqueue(make_unique<player_enter_message>(character->name, character->gender, character->allegiance, character->_class, character->loc->map_name, move(player_stats),
+        q.enqueue(player_enter_message(character->name, character->gender, character->allegiance, character->_class, character->loc->map_name, move(player_stats),
                 user_data->connection_id, character->level, character->gold, character->loc->x, character->loc->y));
     }
 
     template void handle_play_character<server, websocketpp::connection_hdl>(server *s, rapidjson::Document const &d, shared_ptr<database_pool> pool,
-            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
+            per_socket_data<websocketpp::connection_hdl> *user_data, moodycamel::ConcurrentQueue<queue_message> &q, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &user_connections);
 }
@@ -0,0 +1,96 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "batch_response.h"
+#include <algorithm>
+#include <rapidjson/writer.h>
+
+using namespace lotr;
+using namespace rapidjson;
+
+string const batch_response::type = "Batch";
+
+batch_response::batch_response(vector<unique_ptr<message>> messages) noexcept : messages(move(messages)) {
+
+}
+
+string batch_response::serialize() const {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+
+    writer.StartObject();
+
+    writer.String(KEY_STRING("type"));
+    writer.String(type.c_str(), type.size());
+
+    writer.String(KEY_STRING("messages"));
+    writer.StartArray();
+    for(auto const &msg : messages) {
+        auto serialized = msg->serialize();
+        writer.RawValue(serialized.c_str(), serialized.size(), kObjectType);
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+    return sb.GetString();
+}
+
+string batch_response::serialize_binary() const {
+    binary_writer writer(BatchResponse);
+    writer.write_count(messages.size());
+    for(auto const &msg : messages) {
+        auto serialized = msg->serialize_binary();
+        if(serialized.empty()) {
+            return {};
+        }
+        writer.write_string(serialized);
+    }
+    return writer.release();
+}
+
+void lotr::coalesce_by_connection(vector<outward_message> &messages) {
+    if(messages.size() < 2) {
+        return;
+    }
+
+    stable_sort(begin(messages), end(messages), [](outward_message const &a, outward_message const &b) noexcept { return a.conn_id < b.conn_id; });
+
+    uint32_t out = 0;
+    for(uint32_t i = 0; i < messages.size();) {
+        uint32_t run_end = i + 1;
+        while(run_end < messages.size() && messages[run_end].conn_id == messages[i].conn_id) {
+            run_end++;
+        }
+
+        if(run_end - i == 1) {
+            messages[out] = move(messages[i]);
+        } else {
+            vector<unique_ptr<message>> batch;
+            batch.reserve(run_end - i);
+            for(uint32_t j = i; j < run_end; j++) {
+                batch.push_back(move(messages[j].msg));
+            }
+            messages[out] = outward_message{messages[i].conn_id, make_unique<batch_response>(move(batch))};
+        }
+
+        out++;
+        i = run_end;
+    }
+
+    messages.erase(begin(messages) + out, end(messages));
+}
@@ -0,0 +1,51 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "message.h"
+#include "binary_codec.h"
+
+using namespace std;
+
+namespace lotr {
+    // Envelope for everything a connection gets in a single tick, so it costs one frame instead of one per message.
+    // Json: {"type": "Batch", "messages": [...]}, binary: the frames of the messages as length-prefixed strings.
+    struct batch_response : message {
+        explicit batch_response(vector<unique_ptr<message>> messages) noexcept;
+
+        ~batch_response() noexcept = default;
+
+        [[nodiscard]]
+        string serialize() const override;
+
+        // empty if any of the messages has no binary encoding, so the whole batch falls back to json
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        vector<unique_ptr<message>> messages;
+
+        static string const type;
+    };
+
+    // Groups messages by connection, keeping the order per connection. Connections with more than one message get a batch_response.
+    void coalesce_by_connection(vector<outward_message> &messages);
+}
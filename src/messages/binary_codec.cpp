@@ -0,0 +1,214 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "binary_codec.h"
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+vector<binary_schema_entry> const lotr::binary_schema = {
+        {0, "stat", {{"name", "string"}, {"value", "i64"}}},
+        {0, "skill", {{"value", "u32"}, {"name", "string"}}},
+        {0, "item", {{"tier", "u32"}, {"value", "u32"}, {"sprite", "u32"}, {"name", "string"}, {"description", "string"}, {"item_type", "string"}, {"stats", "array<stat>"}}},
+        {0, "character", {{"name", "string"}, {"gender", "string"}, {"allegiance", "string"}, {"baseclass", "string"}, {"map_name", "string"}, {"level", "u32"}, {"slot", "u32"},
+                          {"gold", "u32"}, {"x", "u32"}, {"y", "u32"}, {"stats", "array<stat>"}, {"items", "array<item>"}, {"skills", "array<skill>"}}},
+        {0, "account", {{"is_game_master", "bool"}, {"is_tester", "bool"}, {"has_done_trial", "bool"}, {"trial_ends_unix_timestamp", "u64"}, {"subscription_tier", "u32"}, {"username", "string"}}},
+        {0, "allegiance", {{"name", "string"}, {"description", "string"}, {"stat_mods", "array<stat>"}, {"items", "array<item>"}, {"skills", "array<skill>"}}},
+        {0, "class", {{"name", "string"}, {"description", "string"}, {"stat_mods", "array<stat>"}}},
+        {0, "map_entity", {{"id", "u64"}, {"name", "string"}, {"sprite", "u32"}, {"x", "i32"}, {"y", "i32"}}},
+        {0, "map_move", {{"id", "u64"}, {"x", "i32"}, {"y", "i32"}}},
+        // a complete binary frame, header included, length prefixed like a string
+        {0, "frame", {{"data", "string"}}},
+        {LoginRequest, "Auth:login", {{"username", "string"}, {"password", "string"}}},
+        {LoginResponse, "Auth:login_response", {{"username", "string"}, {"email", "string"}, {"motd", "string"}, {"players", "array<character>"}, {"online_users", "array<account>"}}},
+        {CharacterSelectRequest, "Game:character_select", {}},
+        {CharacterSelectResponse, "Game:character_select_response", {{"base_stats", "array<stat>"}, {"allegiances", "array<allegiance>"}, {"classes", "array<class>"}}},
+        {MessageResponse, "Chat:receive", {{"user", "string"}, {"content", "string"}, {"source", "string"}, {"unix_timestamp", "u64"}}},
+        {MapUpdateResponse, "Game:map_update", {{"npcs", "array<map_entity>"}}},
+        {MapDeltaResponse, "Game:map_delta", {{"entered", "array<map_entity>"}, {"changed", "array<map_entity>"}, {"moved", "array<map_move>"}, {"left", "array<u64>"}}},
+        {BatchResponse, "Batch", {{"messages", "array<frame>"}}},
+};
+
+binary_writer::binary_writer(binary_message_id id) : _buffer() {
+    _buffer.reserve(64);
+    write_u8(binary_protocol_version);
+    write_u16(id);
+}
+
+template <typename T>
+void binary_writer::write_le(T value) {
+    for(size_t i = 0; i < sizeof(T); i++) {
+        _buffer.push_back(static_cast<char>(static_cast<uint8_t>(value >> (i * 8))));
+    }
+}
+
+void binary_writer::write_u8(uint8_t value) {
+    _buffer.push_back(static_cast<char>(value));
+}
+
+void binary_writer::write_bool(bool value) {
+    write_u8(value ? 1 : 0);
+}
+
+void binary_writer::write_u16(uint16_t value) {
+    write_le(value);
+}
+
+void binary_writer::write_u32(uint32_t value) {
+    write_le(value);
+}
+
+void binary_writer::write_u64(uint64_t value) {
+    write_le(value);
+}
+
+void binary_writer::write_i32(int32_t value) {
+    write_le(static_cast<uint32_t>(value));
+}
+
+void binary_writer::write_i64(int64_t value) {
+    write_le(static_cast<uint64_t>(value));
+}
+
+void binary_writer::write_count(uint64_t count) {
+    while(count >= 0x80) {
+        write_u8(static_cast<uint8_t>(count) | 0x80);
+        count >>= 7;
+    }
+    write_u8(static_cast<uint8_t>(count));
+}
+
+void binary_writer::write_string(string const &value) {
+    write_count(value.size());
+    _buffer.append(value);
+}
+
+string binary_writer::release() noexcept {
+    return move(_buffer);
+}
+
+binary_reader::binary_reader(string_view data) noexcept : _data(data), _pos(0), _failed(false) {
+
+}
+
+bool binary_reader::read_header(binary_message_id &id) noexcept {
+    auto version = read_u8();
+    id = static_cast<binary_message_id>(read_u16());
+    return ok() && version == binary_protocol_version;
+}
+
+template <typename T>
+T binary_reader::read_le() noexcept {
+    if(_failed || _data.size() - _pos < sizeof(T)) {
+        _failed = true;
+        return 0;
+    }
+
+    T value = 0;
+    for(size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<uint8_t>(_data[_pos + i])) << (i * 8);
+    }
+    _pos += sizeof(T);
+    return value;
+}
+
+uint8_t binary_reader::read_u8() noexcept {
+    return read_le<uint8_t>();
+}
+
+bool binary_reader::read_bool() noexcept {
+    return read_u8() != 0;
+}
+
+uint16_t binary_reader::read_u16() noexcept {
+    return read_le<uint16_t>();
+}
+
+uint32_t binary_reader::read_u32() noexcept {
+    return read_le<uint32_t>();
+}
+
+uint64_t binary_reader::read_u64() noexcept {
+    return read_le<uint64_t>();
+}
+
+int32_t binary_reader::read_i32() noexcept {
+    return static_cast<int32_t>(read_le<uint32_t>());
+}
+
+int64_t binary_reader::read_i64() noexcept {
+    return static_cast<int64_t>(read_le<uint64_t>());
+}
+
+uint32_t binary_reader::read_count() noexcept {
+    uint64_t count = 0;
+    for(uint32_t shift = 0; shift < 35; shift += 7) {
+        auto byte = read_u8();
+        count |= static_cast<uint64_t>(byte & 0x7F) << shift;
+
+        if((byte & 0x80) == 0) {
+            if(_failed || count > _data.size() - _pos) {
+                _failed = true;
+                return 0;
+            }
+            return static_cast<uint32_t>(count);
+        }
+    }
+
+    _failed = true;
+    return 0;
+}
+
+string binary_reader::read_string() {
+    auto size = read_count();
+    if(_failed) {
+        return {};
+    }
+
+    string value(_data.substr(_pos, size));
+    _pos += size;
+    return value;
+}
+
+bool binary_reader::ok() const noexcept {
+    return !_failed;
+}
+
+bool binary_reader::at_end() const noexcept {
+    return _pos == _data.size();
+}
+
+void lotr::write_stats(binary_writer &writer, vector<stat_component> const &stats) {
+    writer.write_count(stats.size());
+    for(auto const &stat : stats) {
+        writer.write_string(stat.name);
+        writer.write_i64(stat.value);
+    }
+}
+
+bool lotr::read_stats(binary_reader &reader, vector<stat_component> &stats) {
+    auto count = reader.read_count();
+    stats.reserve(stats.size() + count);
+    for(uint32_t i = 0; i < count && reader.ok(); i++) {
+        auto name = reader.read_string();
+        auto value = reader.read_i64();
+        stats.emplace_back(move(name), value);
+    }
+    return reader.ok();
+}
@@ -0,0 +1,119 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+namespace lotr {
+    // Binary frames start with the protocol version (u8) and the message id (u16), followed by the fields in schema order.
+    // Integers are fixed width little-endian, bools are one byte, strings and arrays are prefixed with their length as an unsigned LEB128 varint.
+    constexpr uint8_t binary_protocol_version = 1;
+
+    enum binary_message_id : uint16_t {
+        LoginRequest = 1,
+        LoginResponse,
+        CharacterSelectRequest,
+        CharacterSelectResponse,
+        MessageResponse,
+        MapUpdateResponse,
+        MapDeltaResponse,
+        BatchResponse
+    };
+
+    struct binary_schema_field {
+        string name;
+        string type;
+    };
+
+    // describes the layout of a message or nested object, sent to clients on negotiation
+    struct binary_schema_entry {
+        uint16_t id; // 0 for nested objects
+        string name;
+        vector<binary_schema_field> fields;
+    };
+
+    extern vector<binary_schema_entry> const binary_schema;
+
+    struct stat_component;
+    class binary_writer;
+    class binary_reader;
+
+    void write_stats(binary_writer &writer, vector<stat_component> const &stats);
+    bool read_stats(binary_reader &reader, vector<stat_component> &stats);
+
+    class binary_writer {
+    public:
+        explicit binary_writer(binary_message_id id);
+
+        void write_u8(uint8_t value);
+        void write_bool(bool value);
+        void write_u16(uint16_t value);
+        void write_u32(uint32_t value);
+        void write_u64(uint64_t value);
+        void write_i32(int32_t value);
+        void write_i64(int64_t value);
+        void write_count(uint64_t count);
+        void write_string(string const &value);
+
+        [[nodiscard]] string release() noexcept;
+
+    private:
+        template <typename T>
+        void write_le(T value);
+
+        string _buffer;
+    };
+
+    // Reading past the end or a malformed length marks the reader as failed and returns zero values from then on,
+    // so deserializers only need to check ok() once at the end.
+    class binary_reader {
+    public:
+        explicit binary_reader(string_view data) noexcept;
+
+        // reads and validates the frame header
+        [[nodiscard]] bool read_header(binary_message_id &id) noexcept;
+
+        [[nodiscard]] uint8_t read_u8() noexcept;
+        [[nodiscard]] bool read_bool() noexcept;
+        [[nodiscard]] uint16_t read_u16() noexcept;
+        [[nodiscard]] uint32_t read_u32() noexcept;
+        [[nodiscard]] uint64_t read_u64() noexcept;
+        [[nodiscard]] int32_t read_i32() noexcept;
+        [[nodiscard]] int64_t read_i64() noexcept;
+        // counts larger than the remaining bytes can never be valid and fail the reader, to prevent huge allocations
+        [[nodiscard]] uint32_t read_count() noexcept;
+        [[nodiscard]] string read_string();
+
+        [[nodiscard]] bool ok() const noexcept;
+        [[nodiscard]] bool at_end() const noexcept;
+
+    private:
+        template <typename T>
+        T read_le() noexcept;
+
+        string_view _data;
+        size_t _pos;
+        bool _failed;
+    };
+}
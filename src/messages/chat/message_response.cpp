@@ -67,3 +67,26 @@ optional<message_response> message_response::deserialize(rapidjson::Document con
 
     return message_response(d["user"].GetString(), d["content"].GetString(), d["source"].GetString(), d["unix_timestamp"].GetUint64());
 }
+
+string message_response::serialize_binary() const {
+    binary_writer writer(MessageResponse);
+    writer.write_string(user);
+    writer.write_string(content);
+    writer.write_string(source);
+    writer.write_u64(unix_timestamp);
+    return writer.release();
+}
+
+optional<message_response> message_response::deserialize_binary(binary_reader &reader) {
+    auto user = reader.read_string();
+    auto content = reader.read_string();
+    auto source = reader.read_string();
+    auto unix_timestamp = reader.read_u64();
+
+    if(!reader.ok()) {
+        spdlog::warn("[message_response] binary deserialize failed");
+        return nullopt;
+    }
+
+    return message_response(move(user), move(content), move(source), unix_timestamp);
+}
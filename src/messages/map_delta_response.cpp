@@ -0,0 +1,242 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "map_delta_response.h"
+#include <spdlog/spdlog.h>
+#include <rapidjson/writer.h>
+
+using namespace lotr;
+using namespace rapidjson;
+
+string const map_delta_response::type = "Game:map_delta";
+
+template <typename writer_type>
+void write_entities(writer_type &writer, vector<map_delta_entity> const &entities) {
+    writer.StartArray();
+    for(auto const &entity : entities) {
+        writer.StartObject();
+
+        writer.String(KEY_STRING("id"));
+        writer.Uint64(entity.id);
+
+        writer.String(KEY_STRING("name"));
+        writer.String(entity.name.c_str(), entity.name.size());
+
+        writer.String(KEY_STRING("sprite"));
+        writer.Uint(entity.sprite);
+
+        writer.String(KEY_STRING("x"));
+        writer.Uint(get<0>(entity.loc));
+
+        writer.String(KEY_STRING("y"));
+        writer.Uint(get<1>(entity.loc));
+
+        writer.EndObject();
+    }
+    writer.EndArray();
+}
+
+bool read_entities(rapidjson::Value const &array, vector<map_delta_entity> &entities) {
+    if(!array.IsArray()) {
+        return false;
+    }
+
+    for(SizeType i = 0; i < array.Size(); i++) {
+        if (!array[i].IsObject() ||
+            !array[i].HasMember("id") ||
+            !array[i].HasMember("name") ||
+            !array[i].HasMember("sprite") ||
+            !array[i].HasMember("x") ||
+            !array[i].HasMember("y")) {
+            return false;
+        }
+
+        entities.emplace_back(array[i]["id"].GetUint64(), array[i]["name"].GetString(), array[i]["sprite"].GetUint(), make_tuple(array[i]["x"].GetInt(), array[i]["y"].GetInt()));
+    }
+
+    return true;
+}
+
+map_delta_response::map_delta_response(vector<map_delta_entity> entered, vector<map_delta_entity> changed, vector<map_delta_move> moved, vector<uint64_t> left) noexcept
+    : entered(move(entered)), changed(move(changed)), moved(move(moved)), left(move(left)) {
+
+}
+
+string map_delta_response::serialize() const {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+
+    writer.StartObject();
+
+    writer.String(KEY_STRING("type"));
+    writer.String(type.c_str(), type.size());
+
+    writer.String(KEY_STRING("entered"));
+    write_entities(writer, entered);
+
+    writer.String(KEY_STRING("changed"));
+    write_entities(writer, changed);
+
+    writer.String(KEY_STRING("moved"));
+    writer.StartArray();
+    for(auto const &m : moved) {
+        writer.StartObject();
+
+        writer.String(KEY_STRING("id"));
+        writer.Uint64(m.id);
+
+        writer.String(KEY_STRING("x"));
+        writer.Uint(get<0>(m.loc));
+
+        writer.String(KEY_STRING("y"));
+        writer.Uint(get<1>(m.loc));
+
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.String(KEY_STRING("left"));
+    writer.StartArray();
+    for(auto id : left) {
+        writer.Uint64(id);
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+    return sb.GetString();
+}
+
+optional<map_delta_response> map_delta_response::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("entered") || !d.HasMember("changed") || !d.HasMember("moved") || !d.HasMember("left")) {
+        spdlog::warn("[map_delta_response] deserialize failed");
+        return nullopt;
+    }
+
+    if(d["type"].GetString() != type) {
+        spdlog::warn("[map_delta_response] deserialize failed wrong type");
+        return nullopt;
+    }
+
+    vector<map_delta_entity> entered;
+    vector<map_delta_entity> changed;
+    if(!read_entities(d["entered"], entered) || !read_entities(d["changed"], changed)) {
+        spdlog::warn("[map_delta_response] deserialize failed");
+        return nullopt;
+    }
+
+    vector<map_delta_move> moved;
+    auto &moved_array = d["moved"];
+    if(!moved_array.IsArray()) {
+        spdlog::warn("[map_delta_response] deserialize failed");
+        return nullopt;
+    }
+
+    for(SizeType i = 0; i < moved_array.Size(); i++) {
+        if (!moved_array[i].IsObject() || !moved_array[i].HasMember("id") || !moved_array[i].HasMember("x") || !moved_array[i].HasMember("y")) {
+            spdlog::warn("[map_delta_response] deserialize failed");
+            return nullopt;
+        }
+
+        moved.emplace_back(moved_array[i]["id"].GetUint64(), make_tuple(moved_array[i]["x"].GetInt(), moved_array[i]["y"].GetInt()));
+    }
+
+    vector<uint64_t> left;
+    auto &left_array = d["left"];
+    if(!left_array.IsArray()) {
+        spdlog::warn("[map_delta_response] deserialize failed");
+        return nullopt;
+    }
+
+    for(SizeType i = 0; i < left_array.Size(); i++) {
+        left.push_back(left_array[i].GetUint64());
+    }
+
+    return map_delta_response(move(entered), move(changed), move(moved), move(left));
+}
+
+void write_entities(binary_writer &writer, vector<map_delta_entity> const &entities) {
+    writer.write_count(entities.size());
+    for(auto const &entity : entities) {
+        writer.write_u64(entity.id);
+        writer.write_string(entity.name);
+        writer.write_u32(entity.sprite);
+        writer.write_i32(get<0>(entity.loc));
+        writer.write_i32(get<1>(entity.loc));
+    }
+}
+
+void read_entities(binary_reader &reader, vector<map_delta_entity> &entities) {
+    auto count = reader.read_count();
+    for(uint32_t i = 0; i < count && reader.ok(); i++) {
+        auto id = reader.read_u64();
+        auto name = reader.read_string();
+        auto sprite = reader.read_u32();
+        auto x = reader.read_i32();
+        auto y = reader.read_i32();
+        entities.emplace_back(id, move(name), sprite, make_tuple(x, y));
+    }
+}
+
+string map_delta_response::serialize_binary() const {
+    binary_writer writer(MapDeltaResponse);
+    write_entities(writer, entered);
+    write_entities(writer, changed);
+
+    writer.write_count(moved.size());
+    for(auto const &m : moved) {
+        writer.write_u64(m.id);
+        writer.write_i32(get<0>(m.loc));
+        writer.write_i32(get<1>(m.loc));
+    }
+
+    writer.write_count(left.size());
+    for(auto id : left) {
+        writer.write_u64(id);
+    }
+
+    return writer.release();
+}
+
+optional<map_delta_response> map_delta_response::deserialize_binary(binary_reader &reader) {
+    vector<map_delta_entity> entered;
+    vector<map_delta_entity> changed;
+    read_entities(reader, entered);
+    read_entities(reader, changed);
+
+    vector<map_delta_move> moved;
+    auto moved_count = reader.read_count();
+    for(uint32_t i = 0; i < moved_count && reader.ok(); i++) {
+        auto id = reader.read_u64();
+        auto x = reader.read_i32();
+        auto y = reader.read_i32();
+        moved.emplace_back(id, make_tuple(x, y));
+    }
+
+    vector<uint64_t> left;
+    auto left_count = reader.read_count();
+    for(uint32_t i = 0; i < left_count && reader.ok(); i++) {
+        left.push_back(reader.read_u64());
+    }
+
+    if(!reader.ok()) {
+        spdlog::warn("[map_delta_response] binary deserialize failed");
+        return nullopt;
+    }
+
+    return map_delta_response(move(entered), move(changed), move(moved), move(left));
+}
@@ -0,0 +1,73 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <rapidjson/document.h>
+#include <game_logic/location.h>
+#include "message.h"
+#include "binary_codec.h"
+
+using namespace std;
+
+namespace lotr {
+    struct map_delta_entity {
+        uint64_t id;
+        string name;
+        uint32_t sprite;
+        location loc;
+
+        map_delta_entity(uint64_t id, string name, uint32_t sprite, location loc) noexcept : id(id), name(move(name)), sprite(sprite), loc(loc) {}
+    };
+
+    struct map_delta_move {
+        uint64_t id;
+        location loc;
+
+        map_delta_move(uint64_t id, location loc) noexcept : id(id), loc(loc) {}
+    };
+
+    // changes since the last map_update_response or map_delta_response sent to this connection, keyed by entity id
+    struct map_delta_response : message {
+        map_delta_response(vector<map_delta_entity> entered, vector<map_delta_entity> changed, vector<map_delta_move> moved, vector<uint64_t> left) noexcept;
+
+        ~map_delta_response() noexcept = default;
+
+        [[nodiscard]]
+        string serialize() const override;
+
+        [[nodiscard]]
+        static optional<map_delta_response> deserialize(rapidjson::Document const &d);
+
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<map_delta_response> deserialize_binary(binary_reader &reader);
+
+        vector<map_delta_entity> entered;
+        vector<map_delta_entity> changed;
+        vector<map_delta_move> moved;
+        vector<uint64_t> left;
+
+        static string const type;
+    };
+}
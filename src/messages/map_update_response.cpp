@@ -19,14 +19,13 @@
 #include "map_update_response.h"
 #include <spdlog/spdlog.h>
 #include <rapidjson/writer.h>
-#include <ecs/components.h>
 
 using namespace lotr;
 using namespace rapidjson;
 
 string const map_update_response::type = "Game:map_update";
 
-map_update_response::map_update_response(vector<character_component> npcs) noexcept : npcs(move(npcs)) {
+map_update_response::map_update_response(vector<map_delta_entity> npcs) noexcept : npcs(move(npcs)) {
 
 }
 
@@ -45,6 +44,9 @@ string map_update_response::serialize() const {
     for(auto const &npc: npcs) {
         writer.StartObject();
 
+        writer.String(KEY_STRING("id"));
+        writer.Uint64(npc.id);
+
         writer.String(KEY_STRING("name"));
         writer.String(npc.name.c_str(), npc.name.size());
 
@@ -76,7 +78,7 @@ optional<map_update_response> map_update_response::deserialize(rapidjson::Docume
         return nullopt;
     }
 
-    vector<character_component> players;
+    vector<map_delta_entity> npcs;
     auto &npcs_array = d["npcs"];
     if(!npcs_array.IsArray()) {
         spdlog::warn("[map_update_response] deserialize failed");
@@ -85,6 +87,7 @@ optional<map_update_response> map_update_response::deserialize(rapidjson::Docume
 
     for(SizeType i = 0; i < npcs_array.Size(); i++) {
         if (!npcs_array[i].IsObject() ||
+            !npcs_array[i].HasMember("id") ||
             !npcs_array[i].HasMember("name") ||
             !npcs_array[i].HasMember("sprite") ||
             !npcs_array[i].HasMember("x") ||
@@ -93,13 +96,42 @@ optional<map_update_response> map_update_response::deserialize(rapidjson::Docume
             return nullopt;
         }
 
-        npc_component npc;
-        npc.name = npcs_array[i]["name"].GetString();
-        npc.sprite = npcs_array[i]["sprite"].GetInt();
-        npc.loc = make_tuple(npcs_array[i]["x"].GetInt(), npcs_array[i]["y"].GetInt());
+        npcs.emplace_back(npcs_array[i]["id"].GetUint64(), npcs_array[i]["name"].GetString(), npcs_array[i]["sprite"].GetInt(),
+                          make_tuple(npcs_array[i]["x"].GetInt(), npcs_array[i]["y"].GetInt()));
+    }
+
+    return map_update_response(move(npcs));
+}
+
+string map_update_response::serialize_binary() const {
+    binary_writer writer(MapUpdateResponse);
+    writer.write_count(npcs.size());
+    for(auto const &npc : npcs) {
+        writer.write_u64(npc.id);
+        writer.write_string(npc.name);
+        writer.write_u32(npc.sprite);
+        writer.write_i32(get<0>(npc.loc));
+        writer.write_i32(get<1>(npc.loc));
+    }
+    return writer.release();
+}
 
-        players.push_back(npc);
+optional<map_update_response> map_update_response::deserialize_binary(binary_reader &reader) {
+    vector<map_delta_entity> npcs;
+    auto count = reader.read_count();
+    for(uint32_t i = 0; i < count && reader.ok(); i++) {
+        auto id = reader.read_u64();
+        auto name = reader.read_string();
+        auto sprite = reader.read_u32();
+        auto x = reader.read_i32();
+        auto y = reader.read_i32();
+        npcs.emplace_back(id, move(name), sprite, make_tuple(x, y));
+    }
+
+    if(!reader.ok()) {
+        spdlog::warn("[map_update_response] binary deserialize failed");
+        return nullopt;
     }
 
-    return map_update_response(players);
+    return map_update_response(move(npcs));
 }
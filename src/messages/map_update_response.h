@@ -23,14 +23,14 @@
 #include <optional>
 #include <rapidjson/document.h>
 #include "message.h"
+#include "binary_codec.h"
+#include "map_delta_response.h"
 
 using namespace std;
 
 namespace lotr {
-    struct character_component;
-
     struct map_update_response : message {
-        map_update_response(vector<character_component> npcs) noexcept;
+        map_update_response(vector<map_delta_entity> npcs) noexcept;
 
         ~map_update_response() noexcept = default;
 
@@ -40,7 +40,13 @@ namespace lotr {
         [[nodiscard]]
         static optional<map_update_response> deserialize(rapidjson::Document const &d);
 
-        vector<character_component> npcs;
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<map_update_response> deserialize_binary(binary_reader &reader);
+
+        vector<map_delta_entity> npcs;
 
         static string const type;
     };
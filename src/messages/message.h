@@ -35,6 +35,9 @@ namespace lotr {
         virtual ~message() = default;
         [[nodiscard]]
         virtual string serialize() const = 0;
+        // binary protocol encoding, messages without one return an empty string and are sent as json
+        [[nodiscard]]
+        virtual string serialize_binary() const { return {}; }
     };
 
     struct outward_message {
@@ -50,3 +50,28 @@ bool lotr::read_account_object_into_vector(rapidjson::Value const &value, vector
             value["subscription_tier"].GetUint(), value["username"].GetString());
     return true;
 }
+
+void lotr::write_account_object(binary_writer &writer, account_object const &obj) {
+    writer.write_bool(obj.is_game_master);
+    writer.write_bool(obj.is_tester);
+    writer.write_bool(obj.has_done_trial);
+    writer.write_u64(obj.trial_ends_unix_timestamp);
+    writer.write_u32(obj.subscription_tier);
+    writer.write_string(obj.username);
+}
+
+bool lotr::read_account_object_into_vector(binary_reader &reader, vector<account_object> &objs) {
+    auto is_game_master = reader.read_bool();
+    auto is_tester = reader.read_bool();
+    auto has_done_trial = reader.read_bool();
+    auto trial_ends_unix_timestamp = reader.read_u64();
+    auto subscription_tier = reader.read_u32();
+    auto username = reader.read_string();
+
+    if(!reader.ok()) {
+        return false;
+    }
+
+    objs.emplace_back(is_game_master, is_tester, has_done_trial, trial_ends_unix_timestamp, subscription_tier, move(username));
+    return true;
+}
@@ -22,6 +22,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/pointer.h>
 #include "messages/message.h"
+#include "messages/binary_codec.h"
 
 using namespace std;
 
@@ -40,4 +41,6 @@ namespace lotr {
 
     void write_account_object(rapidjson::Writer<rapidjson::StringBuffer> &writer, account_object const &obj);
     bool read_account_object_into_vector(rapidjson::Value const &value, vector<account_object> &objs);
+    void write_account_object(binary_writer &writer, account_object const &obj);
+    bool read_account_object_into_vector(binary_reader &reader, vector<account_object> &objs);
 }
@@ -138,3 +138,68 @@ bool lotr::read_character_object_into_vector(rapidjson::Value const &value, vect
                       value["level"].GetUint(), value["slot"].GetUint(), value["gold"].GetUint(), value["x"].GetUint(), value["y"].GetUint(), move(stats), move(items), move(skills));
     return true;
 }
+
+void lotr::write_character_object(binary_writer &writer, character_object const &obj) {
+    writer.write_string(obj.name);
+    writer.write_string(obj.gender);
+    writer.write_string(obj.allegiance);
+    writer.write_string(obj.baseclass);
+    writer.write_string(obj.map_name);
+    writer.write_u32(obj.level);
+    writer.write_u32(obj.slot);
+    writer.write_u32(obj.gold);
+    writer.write_u32(obj.x);
+    writer.write_u32(obj.y);
+    write_stats(writer, obj.stats);
+
+    writer.write_count(obj.items.size());
+    for(auto const &item : obj.items) {
+        write_item_object(writer, item);
+    }
+
+    writer.write_count(obj.skills.size());
+    for(auto const &skill : obj.skills) {
+        write_skill_object(writer, skill);
+    }
+}
+
+bool lotr::read_character_object_into_vector(binary_reader &reader, vector<character_object> &objs) {
+    auto name = reader.read_string();
+    auto gender = reader.read_string();
+    auto allegiance = reader.read_string();
+    auto baseclass = reader.read_string();
+    auto map_name = reader.read_string();
+    auto level = reader.read_u32();
+    auto slot = reader.read_u32();
+    auto gold = reader.read_u32();
+    auto x = reader.read_u32();
+    auto y = reader.read_u32();
+
+    vector<stat_component> stats;
+    if(!read_stats(reader, stats)) {
+        return false;
+    }
+
+    vector<item_object> items;
+    auto item_count = reader.read_count();
+    for(uint32_t i = 0; i < item_count; i++) {
+        if(!read_item_object_into_vector(reader, items)) {
+            return false;
+        }
+    }
+
+    vector<skill_object> skills;
+    auto skill_count = reader.read_count();
+    for(uint32_t i = 0; i < skill_count; i++) {
+        if(!read_skill_object_into_vector(reader, skills)) {
+            return false;
+        }
+    }
+
+    if(!reader.ok()) {
+        return false;
+    }
+
+    objs.emplace_back(move(name), move(gender), move(allegiance), move(baseclass), move(map_name), level, slot, gold, x, y, move(stats), move(items), move(skills));
+    return true;
+}
@@ -22,6 +22,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/pointer.h>
 #include "messages/message.h"
+#include "messages/binary_codec.h"
 #include "item_object.h"
 #include "skill_object.h"
 
@@ -49,4 +50,6 @@ namespace lotr {
 
     void write_character_object(rapidjson::Writer<rapidjson::StringBuffer> &writer, character_object const &obj);
     bool read_character_object_into_vector(rapidjson::Value const &value, vector<character_object> &objs);
+    void write_character_object(binary_writer &writer, character_object const &obj);
+    bool read_character_object_into_vector(binary_reader &reader, vector<character_object> &objs);
 }
@@ -81,3 +81,30 @@ bool lotr::read_item_object_into_vector(rapidjson::Value const &value, vector<it
             value["item_type"].GetString(), move(stats));
     return true;
 }
+
+void lotr::write_item_object(binary_writer &writer, item_object const &obj) {
+    writer.write_u32(obj.tier);
+    writer.write_u32(obj.value);
+    writer.write_u32(obj.sprite);
+    writer.write_string(obj.name);
+    writer.write_string(obj.description);
+    writer.write_string(obj.item_type);
+    write_stats(writer, obj.stats);
+}
+
+bool lotr::read_item_object_into_vector(binary_reader &reader, vector<item_object> &objs) {
+    auto tier = reader.read_u32();
+    auto value = reader.read_u32();
+    auto sprite = reader.read_u32();
+    auto name = reader.read_string();
+    auto description = reader.read_string();
+    auto item_type = reader.read_string();
+    vector<stat_component> stats;
+
+    if(!read_stats(reader, stats)) {
+        return false;
+    }
+
+    objs.emplace_back(tier, value, sprite, move(name), move(description), move(item_type), move(stats));
+    return true;
+}
@@ -22,6 +22,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/pointer.h>
 #include "messages/message.h"
+#include "messages/binary_codec.h"
 
 using namespace std;
 
@@ -42,4 +43,6 @@ namespace lotr {
 
     void write_item_object(rapidjson::Writer<rapidjson::StringBuffer> &writer, item_object const &obj);
     bool read_item_object_into_vector(rapidjson::Value const &value, vector<item_object> &objs);
+    void write_item_object(binary_writer &writer, item_object const &obj);
+    bool read_item_object_into_vector(binary_reader &reader, vector<item_object> &objs);
 }
@@ -35,3 +35,20 @@ bool lotr::read_skill_object_into_vector(rapidjson::Value const &value, vector<s
     objs.emplace_back(value["name"].GetString(), value["value"].GetUint());
     return true;
 }
+
+void lotr::write_skill_object(binary_writer &writer, skill_object const &obj) {
+    writer.write_u32(obj.value);
+    writer.write_string(obj.name);
+}
+
+bool lotr::read_skill_object_into_vector(binary_reader &reader, vector<skill_object> &objs) {
+    auto value = reader.read_u32();
+    auto name = reader.read_string();
+
+    if(!reader.ok()) {
+        return false;
+    }
+
+    objs.emplace_back(move(name), value);
+    return true;
+}
@@ -22,6 +22,7 @@
 #include <rapidjson/writer.h>
 #include <rapidjson/pointer.h>
 #include "messages/message.h"
+#include "messages/binary_codec.h"
 
 using namespace std;
 
@@ -36,4 +37,6 @@ namespace lotr {
 
     void write_skill_object(rapidjson::Writer<rapidjson::StringBuffer> &writer, skill_object const &obj);
     bool read_skill_object_into_vector(rapidjson::Value const &value, vector<skill_object> &objs);
+    void write_skill_object(binary_writer &writer, skill_object const &obj);
+    bool read_skill_object_into_vector(binary_reader &reader, vector<skill_object> &objs);
 }
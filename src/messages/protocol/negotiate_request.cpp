@@ -0,0 +1,63 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "negotiate_request.h"
+#include <spdlog/spdlog.h>
+#include <rapidjson/writer.h>
+
+using namespace lotr;
+using namespace rapidjson;
+
+string const negotiate_request::type = "Protocol:negotiate";
+
+negotiate_request::negotiate_request(string encoding, uint32_t version) noexcept : encoding(move(encoding)), version(version) {
+
+}
+
+string negotiate_request::serialize() const {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+
+    writer.StartObject();
+
+    writer.String(KEY_STRING("type"));
+    writer.String(type.c_str(), type.size());
+
+    writer.String(KEY_STRING("encoding"));
+    writer.String(encoding.c_str(), encoding.size());
+
+    writer.String(KEY_STRING("version"));
+    writer.Uint(version);
+
+    writer.EndObject();
+    return sb.GetString();
+}
+
+optional<negotiate_request> negotiate_request::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("encoding") || !d.HasMember("version")) {
+        spdlog::warn("[negotiate_request] deserialize failed");
+        return nullopt;
+    }
+
+    if(d["type"].GetString() != type) {
+        spdlog::warn("[negotiate_request] deserialize failed wrong type");
+        return nullopt;
+    }
+
+    return negotiate_request(d["encoding"].GetString(), d["version"].GetUint());
+}
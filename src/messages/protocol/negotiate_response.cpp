@@ -0,0 +1,122 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "negotiate_response.h"
+#include <spdlog/spdlog.h>
+#include <rapidjson/writer.h>
+
+using namespace lotr;
+using namespace rapidjson;
+
+string const negotiate_response::type = "Protocol:negotiated";
+
+negotiate_response::negotiate_response(string encoding, uint32_t version, vector<binary_schema_entry> schema) noexcept
+    : encoding(move(encoding)), version(version), schema(move(schema)) {
+
+}
+
+string negotiate_response::serialize() const {
+    StringBuffer sb;
+    Writer<StringBuffer> writer(sb);
+
+    writer.StartObject();
+
+    writer.String(KEY_STRING("type"));
+    writer.String(type.c_str(), type.size());
+
+    writer.String(KEY_STRING("encoding"));
+    writer.String(encoding.c_str(), encoding.size());
+
+    writer.String(KEY_STRING("version"));
+    writer.Uint(version);
+
+    writer.String(KEY_STRING("schema"));
+    writer.StartArray();
+    for(auto const &entry : schema) {
+        writer.StartObject();
+
+        writer.String(KEY_STRING("id"));
+        writer.Uint(entry.id);
+
+        writer.String(KEY_STRING("name"));
+        writer.String(entry.name.c_str(), entry.name.size());
+
+        writer.String(KEY_STRING("fields"));
+        writer.StartArray();
+        for(auto const &field : entry.fields) {
+            writer.StartObject();
+
+            writer.String(KEY_STRING("name"));
+            writer.String(field.name.c_str(), field.name.size());
+
+            writer.String(KEY_STRING("type"));
+            writer.String(field.type.c_str(), field.type.size());
+
+            writer.EndObject();
+        }
+        writer.EndArray();
+
+        writer.EndObject();
+    }
+    writer.EndArray();
+
+    writer.EndObject();
+    return sb.GetString();
+}
+
+optional<negotiate_response> negotiate_response::deserialize(rapidjson::Document const &d) {
+    if (!d.HasMember("type") || !d.HasMember("encoding") || !d.HasMember("version") || !d.HasMember("schema")) {
+        spdlog::warn("[negotiate_response] deserialize failed");
+        return nullopt;
+    }
+
+    if(d["type"].GetString() != type) {
+        spdlog::warn("[negotiate_response] deserialize failed wrong type");
+        return nullopt;
+    }
+
+    auto &schema_array = d["schema"];
+    if(!schema_array.IsArray()) {
+        spdlog::warn("[negotiate_response] deserialize failed");
+        return nullopt;
+    }
+
+    vector<binary_schema_entry> schema;
+    for(SizeType i = 0; i < schema_array.Size(); i++) {
+        if(!schema_array[i].IsObject() || !schema_array[i].HasMember("id") || !schema_array[i].HasMember("name") ||
+           !schema_array[i].HasMember("fields") || !schema_array[i]["fields"].IsArray()) {
+            spdlog::warn("[negotiate_response] deserialize failed");
+            return nullopt;
+        }
+
+        auto &fields_array = schema_array[i]["fields"];
+        vector<binary_schema_field> fields;
+        for(SizeType j = 0; j < fields_array.Size(); j++) {
+            if(!fields_array[j].IsObject() || !fields_array[j].HasMember("name") || !fields_array[j].HasMember("type")) {
+                spdlog::warn("[negotiate_response] deserialize failed");
+                return nullopt;
+            }
+
+            fields.push_back(binary_schema_field{fields_array[j]["name"].GetString(), fields_array[j]["type"].GetString()});
+        }
+
+        schema.push_back(binary_schema_entry{static_cast<uint16_t>(schema_array[i]["id"].GetUint()), schema_array[i]["name"].GetString(), move(fields)});
+    }
+
+    return negotiate_response(d["encoding"].GetString(), d["version"].GetUint(), move(schema));
+}
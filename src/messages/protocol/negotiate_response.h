@@ -0,0 +1,49 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <optional>
+#include <rapidjson/document.h>
+#include "../message.h"
+#include "../binary_codec.h"
+
+using namespace std;
+
+namespace lotr {
+    // the encoding the server will use from now on, with the layout of every binary message when that's binary
+    struct negotiate_response : message {
+        negotiate_response(string encoding, uint32_t version, vector<binary_schema_entry> schema) noexcept;
+
+        ~negotiate_response() noexcept = default;
+
+        [[nodiscard]]
+        string serialize() const override;
+
+        [[nodiscard]]
+        static optional<negotiate_response> deserialize(rapidjson::Document const &d);
+
+        string encoding;
+        uint32_t version;
+        vector<binary_schema_entry> schema;
+
+        static string const type;
+    };
+}
@@ -55,3 +55,12 @@ optional<character_select_request> character_select_request::deserialize(rapidjs
 
     return character_select_request{};
 }
+
+string character_select_request::serialize_binary() const {
+    binary_writer writer(CharacterSelectRequest);
+    return writer.release();
+}
+
+optional<character_select_request> character_select_request::deserialize_binary(binary_reader &) {
+    return character_select_request{};
+}
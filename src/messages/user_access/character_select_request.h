@@ -22,6 +22,7 @@
 #include <optional>
 #include <rapidjson/document.h>
 #include "../message.h"
+#include "../binary_codec.h"
 
 using namespace std;
 
@@ -37,6 +38,12 @@ namespace lotr {
         [[nodiscard]]
         static optional<character_select_request> deserialize(rapidjson::Document const &d);
 
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<character_select_request> deserialize_binary(binary_reader &reader);
+
         static string const type;
     };
 }
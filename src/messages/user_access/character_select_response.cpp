@@ -300,3 +300,97 @@ optional<character_select_response> character_select_response::deserialize(rapid
 
     return character_select_response(move(base_stats), move(allegiances), move(classes));
 }
+
+string character_select_response::serialize_binary() const {
+    binary_writer writer(CharacterSelectResponse);
+    write_stats(writer, base_stats);
+
+    writer.write_count(allegiances.size());
+    for(auto const &allegiance : allegiances) {
+        writer.write_string(allegiance.name);
+        writer.write_string(allegiance.description);
+        write_stats(writer, allegiance.stat_mods);
+
+        writer.write_count(allegiance.items.size());
+        for(auto const &item : allegiance.items) {
+            write_item_object(writer, item);
+        }
+
+        writer.write_count(allegiance.skills.size());
+        for(auto const &skill : allegiance.skills) {
+            write_skill_object(writer, skill);
+        }
+    }
+
+    writer.write_count(classes.size());
+    for(auto const &c : classes) {
+        writer.write_string(c.name);
+        writer.write_string(c.description);
+        write_stats(writer, c.stat_mods);
+    }
+
+    return writer.release();
+}
+
+optional<character_select_response> character_select_response::deserialize_binary(binary_reader &reader) {
+    vector<stat_component> base_stats;
+    if(!read_stats(reader, base_stats)) {
+        spdlog::warn("[character_select_response] binary deserialize failed");
+        return nullopt;
+    }
+
+    vector<character_allegiance> allegiances;
+    auto allegiance_count = reader.read_count();
+    for(uint32_t i = 0; i < allegiance_count; i++) {
+        auto name = reader.read_string();
+        auto description = reader.read_string();
+        vector<stat_component> stat_mods;
+        vector<item_object> items;
+        vector<skill_object> skills;
+
+        if(!read_stats(reader, stat_mods)) {
+            spdlog::warn("[character_select_response] binary deserialize failed");
+            return nullopt;
+        }
+
+        auto item_count = reader.read_count();
+        for(uint32_t j = 0; j < item_count; j++) {
+            if(!read_item_object_into_vector(reader, items)) {
+                spdlog::warn("[character_select_response] binary deserialize failed");
+                return nullopt;
+            }
+        }
+
+        auto skill_count = reader.read_count();
+        for(uint32_t j = 0; j < skill_count; j++) {
+            if(!read_skill_object_into_vector(reader, skills)) {
+                spdlog::warn("[character_select_response] binary deserialize failed");
+                return nullopt;
+            }
+        }
+
+        allegiances.emplace_back(move(name), move(description), move(stat_mods), move(items), move(skills));
+    }
+
+    vector<character_class> classes;
+    auto class_count = reader.read_count();
+    for(uint32_t i = 0; i < class_count; i++) {
+        auto name = reader.read_string();
+        auto description = reader.read_string();
+        vector<stat_component> stat_mods;
+
+        if(!read_stats(reader, stat_mods)) {
+            spdlog::warn("[character_select_response] binary deserialize failed");
+            return nullopt;
+        }
+
+        classes.emplace_back(move(name), move(description), move(stat_mods));
+    }
+
+    if(!reader.ok()) {
+        spdlog::warn("[character_select_response] binary deserialize failed");
+        return nullopt;
+    }
+
+    return character_select_response(move(base_stats), move(allegiances), move(classes));
+}
@@ -22,6 +22,7 @@
 #include <optional>
 #include <rapidjson/document.h>
 #include "../message.h"
+#include "../binary_codec.h"
 #include "messages/objects/item_object.h"
 #include "messages/objects/skill_object.h"
 
@@ -58,6 +59,12 @@ namespace lotr {
         [[nodiscard]]
         static optional<character_select_response> deserialize(rapidjson::Document const &d);
 
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<character_select_response> deserialize_binary(binary_reader &reader);
+
         vector<stat_component> base_stats;
         vector<character_allegiance> allegiances;
         vector<character_class> classes;
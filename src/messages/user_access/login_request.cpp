@@ -61,3 +61,22 @@ optional<login_request> login_request::deserialize(rapidjson::Document const &d)
 
     return login_request(d["username"].GetString(), d["password"].GetString());
 }
+
+string login_request::serialize_binary() const {
+    binary_writer writer(LoginRequest);
+    writer.write_string(username);
+    writer.write_string(password);
+    return writer.release();
+}
+
+optional<login_request> login_request::deserialize_binary(binary_reader &reader) {
+    auto username = reader.read_string();
+    auto password = reader.read_string();
+
+    if(!reader.ok()) {
+        spdlog::warn("[login_request] binary deserialize failed");
+        return nullopt;
+    }
+
+    return login_request(move(username), move(password));
+}
@@ -22,6 +22,7 @@
 #include <optional>
 #include <rapidjson/document.h>
 #include "../message.h"
+#include "../binary_codec.h"
 
 using namespace std;
 
@@ -37,6 +38,12 @@ namespace lotr {
         [[nodiscard]]
         static optional<login_request> deserialize(rapidjson::Document const &d);
 
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<login_request> deserialize_binary(binary_reader &reader);
+
         string username;
         string password;
 
@@ -118,3 +118,53 @@ optional<login_response> login_response::deserialize(rapidjson::Document const &
 
     return login_response(move(players), move(online_users), d["username"].GetString(), d["email"].GetString(), d["motd"].GetString());
 }
+
+string login_response::serialize_binary() const {
+    binary_writer writer(LoginResponse);
+    writer.write_string(username);
+    writer.write_string(email);
+    writer.write_string(motd);
+
+    writer.write_count(players.size());
+    for(auto const &player : players) {
+        write_character_object(writer, player);
+    }
+
+    writer.write_count(online_users.size());
+    for(auto const &user : online_users) {
+        write_account_object(writer, user);
+    }
+
+    return writer.release();
+}
+
+optional<login_response> login_response::deserialize_binary(binary_reader &reader) {
+    auto username = reader.read_string();
+    auto email = reader.read_string();
+    auto motd = reader.read_string();
+
+    vector<character_object> players;
+    auto player_count = reader.read_count();
+    for(uint32_t i = 0; i < player_count; i++) {
+        if(!read_character_object_into_vector(reader, players)) {
+            spdlog::warn("[login_response] binary deserialize failed");
+            return nullopt;
+        }
+    }
+
+    vector<account_object> online_users;
+    auto user_count = reader.read_count();
+    for(uint32_t i = 0; i < user_count; i++) {
+        if(!read_account_object_into_vector(reader, online_users)) {
+            spdlog::warn("[login_response] binary deserialize failed");
+            return nullopt;
+        }
+    }
+
+    if(!reader.ok()) {
+        spdlog::warn("[login_response] binary deserialize failed");
+        return nullopt;
+    }
+
+    return login_response(move(players), move(online_users), move(username), move(email), move(motd));
+}
@@ -23,6 +23,7 @@
 #include <vector>
 #include <rapidjson/document.h>
 #include "../message.h"
+#include "../binary_codec.h"
 #include "messages/objects/account_object.h"
 #include "messages/objects/character_object.h"
 
@@ -40,6 +41,12 @@ namespace lotr {
         [[nodiscard]]
         static optional<login_response> deserialize(rapidjson::Document const &d);
 
+        [[nodiscard]]
+        string serialize_binary() const override;
+
+        [[nodiscard]]
+        static optional<login_response> deserialize_binary(binary_reader &reader);
+
         vector<character_object> players;
         vector<account_object> online_users;
         string username;
@@ -0,0 +1,107 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+namespace lotr {
+    // HDR style log-linear histogram. Values below 2 * sub_bucket_count are stored exactly, above that every power of two
+    // is split into sub_bucket_count buckets, giving ~3% precision over the whole range. Recording never allocates.
+    class latency_histogram {
+    public:
+        static constexpr uint32_t sub_bucket_bits = 5;
+        static constexpr uint32_t sub_bucket_count = 1U << sub_bucket_bits;
+        static constexpr uint32_t max_value_bits = 40;
+        static constexpr uint64_t max_value = (1ULL << max_value_bits) - 1;
+        static constexpr uint32_t bucket_count = 2 * sub_bucket_count + (max_value_bits - sub_bucket_bits - 1) * sub_bucket_count;
+
+        latency_histogram() noexcept : _counts{}, _total(0), _max(0), _sum(0) {}
+
+        void record(uint64_t value) noexcept {
+            value = min(value, max_value);
+            _counts[bucket_index(value)]++;
+            _total++;
+            _sum += value;
+            _max = max(_max, value);
+        }
+
+        // percentile in [0, 100], returns the highest value equivalent to the bucket the percentile falls in
+        [[nodiscard]]
+        uint64_t value_at_percentile(double percentile) const noexcept {
+            if(_total == 0) {
+                return 0;
+            }
+
+            uint64_t target = max<uint64_t>(1, static_cast<uint64_t>(ceil(percentile / 100.0 * _total)));
+            uint64_t seen = 0;
+            for(uint32_t i = 0; i < bucket_count; i++) {
+                seen += _counts[i];
+                if(seen >= target) {
+                    return min(bucket_upper_value(i), _max);
+                }
+            }
+
+            return _max;
+        }
+
+        [[nodiscard]] uint64_t total() const noexcept { return _total; }
+        [[nodiscard]] uint64_t max_recorded() const noexcept { return _max; }
+        [[nodiscard]] uint64_t mean() const noexcept { return _total == 0 ? 0 : _sum / _total; }
+
+        void reset() noexcept {
+            _counts.fill(0);
+            _total = 0;
+            _max = 0;
+            _sum = 0;
+        }
+
+        [[nodiscard]]
+        static constexpr uint32_t bucket_index(uint64_t value) noexcept {
+            if(value < 2 * sub_bucket_count) {
+                return value;
+            }
+
+            uint32_t shift = 63 - __builtin_clzll(value) - sub_bucket_bits;
+            uint32_t top = value >> shift;
+            return 2 * sub_bucket_count + (shift - 1) * sub_bucket_count + (top - sub_bucket_count);
+        }
+
+        [[nodiscard]]
+        static constexpr uint64_t bucket_upper_value(uint32_t index) noexcept {
+            if(index < 2 * sub_bucket_count) {
+                return index;
+            }
+
+            uint32_t shift = (index - 2 * sub_bucket_count) / sub_bucket_count + 1;
+            uint64_t top = (index - 2 * sub_bucket_count) % sub_bucket_count + sub_bucket_count;
+            return ((top + 1) << shift) - 1;
+        }
+
+    private:
+        array<uint32_t, bucket_count> _counts;
+        uint64_t _total;
+        uint64_t _max;
+        uint64_t _sum;
+    };
+}
@@ -0,0 +1,75 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tick_profiler.h"
+#include <spdlog/spdlog.h>
+
+using namespace std;
+using namespace lotr;
+
+array<string const, tick_phase_count> const lotr::tick_phase_names = {"queue"s, "fov"s, "visibility"s, "spawning"s, "ai"s, "send"s, "jitter"s, "total"s};
+
+tick_profiler::tick_profiler(vector<string> map_names) : _tick(), _maps(map_names.size()), _map_names(move(map_names)) {
+
+}
+
+void tick_profiler::record_tick(tick_phase_timings const &timings) noexcept {
+    for(uint32_t i = 0; i < tick_phase_count; i++) {
+        _tick[i].record(timings[i]);
+    }
+}
+
+void tick_profiler::record_map_tick(uint32_t map_index, tick_phase_timings const &timings) noexcept {
+    auto &histograms = _maps[map_index];
+    for(uint32_t i = Fov; i <= Ai; i++) {
+        histograms[i].record(timings[i]);
+    }
+    histograms[Total].record(timings[Total]);
+}
+
+void tick_profiler::publish() {
+    spdlog::info("[{}] ticks {} - µs p50/p90/p99/p999/max", __FUNCTION__, _tick[Total].total());
+
+    for(uint32_t i = 0; i < tick_phase_count; i++) {
+        auto &h = _tick[i];
+        spdlog::info("[{}] {:>10}: {} / {} / {} / {} / {}", __FUNCTION__, tick_phase_names[i], h.value_at_percentile(50) / 1'000, h.value_at_percentile(90) / 1'000,
+                     h.value_at_percentile(99) / 1'000, h.value_at_percentile(99.9) / 1'000, h.max_recorded() / 1'000);
+        h.reset();
+    }
+
+    for(uint32_t m = 0; m < _maps.size(); m++) {
+        for(uint32_t i = 0; i < tick_phase_count; i++) {
+            auto &h = _maps[m][i];
+            if(h.total() == 0) {
+                continue;
+            }
+
+            spdlog::debug("[{}] map {} {:>10}: {} / {} / {} / {} / {}", __FUNCTION__, _map_names[m], tick_phase_names[i], h.value_at_percentile(50) / 1'000,
+                          h.value_at_percentile(90) / 1'000, h.value_at_percentile(99) / 1'000, h.value_at_percentile(99.9) / 1'000, h.max_recorded() / 1'000);
+            h.reset();
+        }
+    }
+}
+
+latency_histogram const &tick_profiler::tick_histogram(tick_phase phase) const noexcept {
+    return _tick[phase];
+}
+
+latency_histogram const &tick_profiler::map_histogram(uint32_t map_index, tick_phase phase) const noexcept {
+    return _maps[map_index][phase];
+}
@@ -0,0 +1,74 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "latency_histogram.h"
+
+using namespace std;
+
+namespace lotr {
+    enum tick_phase : uint32_t {
+        QueueDrain = 0,
+        Fov,
+        Visibility,
+        Spawning,
+        Ai,
+        Send,
+        // how late the tick started compared to when it was scheduled
+        Jitter,
+        Total
+    };
+
+    constexpr uint32_t tick_phase_count = 8;
+    extern array<string const, tick_phase_count> const tick_phase_names;
+
+    // nanoseconds spent per phase
+    using tick_phase_timings = array<uint64_t, tick_phase_count>;
+
+    inline uint64_t elapsed_ns(chrono::steady_clock::time_point const start) noexcept {
+        return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+    }
+
+    class tick_profiler {
+    public:
+        explicit tick_profiler(vector<string> map_names);
+
+        // whole tick, fov/visibility/spawning/ai are summed over all maps and thus are cpu time rather than wall time when ticking in parallel
+        void record_tick(tick_phase_timings const &timings) noexcept;
+        // safe to call concurrently for different maps
+        void record_map_tick(uint32_t map_index, tick_phase_timings const &timings) noexcept;
+
+        // logs percentiles of everything recorded since the last publish and starts over
+        void publish();
+
+        [[nodiscard]]
+        latency_histogram const &tick_histogram(tick_phase phase) const noexcept;
+        [[nodiscard]]
+        latency_histogram const &map_histogram(uint32_t map_index, tick_phase phase) const noexcept;
+
+    private:
+        array<latency_histogram, tick_phase_count> _tick;
+        vector<array<latency_histogram, tick_phase_count>> _maps;
+        vector<string> _map_names;
+    };
+}
@@ -22,6 +22,7 @@
 #include <websocketpp/server.hpp>
 #include <websocketpp/config/asio.hpp>
 #pragma GCC diagnostic pop
+#include <messages/message.h>
 
 namespace lotr {
     using server = websocketpp::server<websocketpp::config::asio_tls>;
@@ -34,9 +35,25 @@ namespace lotr {
         bool is_tester;
         bool is_game_master;
         int32_t playing_character_slot;
+        // 0 for json, otherwise the negotiated binary protocol version
+        uint8_t binary_protocol_version;
         string username;
         WebSocket ws;
 
-        per_socket_data() : connection_id(0), user_id(0), subscription_tier(0), is_tester(), is_game_master(), playing_character_slot(), username(), ws() {}
+        per_socket_data() : connection_id(0), user_id(0), subscription_tier(0), is_tester(), is_game_master(), playing_character_slot(), binary_protocol_version(0), username(), ws() {}
     };
+
+    // binary frame if the connection negotiated the binary protocol and the message has a binary encoding, json text frame otherwise
+    template <class Server, class WebSocket>
+    void send_message(Server *s, per_socket_data<WebSocket> const &user_data, message const &msg) {
+        if(user_data.binary_protocol_version > 0) {
+            auto binary = msg.serialize_binary();
+            if(!binary.empty()) {
+                s->send(user_data.ws, binary, websocketpp::frame::opcode::value::BINARY);
+                return;
+            }
+        }
+
+        s->send(user_data.ws, msg.serialize(), websocketpp::frame::opcode::value::TEXT);
+    }
 }
@@ -0,0 +1,142 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "send_pipeline.h"
+#include <spdlog/spdlog.h>
+
+using namespace std;
+using namespace lotr;
+
+send_pipeline::send_pipeline(uint32_t thread_count, function<void(vector<outward_message> &)> send, uint32_t max_pending_per_connection, function<void(uint64_t)> overflow)
+    : _send(move(send)), _overflow(move(overflow)), _max_pending_per_connection(max_pending_per_connection), _dropped(), _overflowed(), _workers(), _threads() {
+    thread_count = max(thread_count, 1U);
+    for(uint32_t i = 0; i < thread_count; i++) {
+        _workers.emplace_back(make_unique<worker>());
+    }
+
+    _threads.reserve(thread_count);
+    for(uint32_t i = 0; i < thread_count; i++) {
+        _threads.emplace_back(&send_pipeline::worker_loop, this, i);
+    }
+}
+
+send_pipeline::~send_pipeline() {
+    for(auto &w : _workers) {
+        unique_lock lock(w->pending_mutex);
+        w->quit = true;
+    }
+
+    for(auto &w : _workers) {
+        w->wake_cv.notify_all();
+    }
+
+    for(auto &t : _threads) {
+        t.join();
+    }
+}
+
+void send_pipeline::submit(vector<outward_message> &messages) {
+    if(messages.empty()) {
+        return;
+    }
+
+    // bucket outside of the locks, so a worker is only blocked for the final move
+    for(auto &msg : messages) {
+        _workers[msg.conn_id % _workers.size()]->scratch.push_back(move(msg));
+    }
+    messages.clear();
+
+    for(auto &w : _workers) {
+        if(w->scratch.empty()) {
+            continue;
+        }
+
+        {
+            unique_lock lock(w->pending_mutex);
+            for(auto &msg : w->scratch) {
+                // one over the cap marks the connection as reported until the worker drains it
+                auto &count = w->pending_counts[msg.conn_id];
+                if(count >= _max_pending_per_connection) {
+                    if(count == _max_pending_per_connection) {
+                        count++;
+                        _overflowed.push_back(msg.conn_id);
+                    }
+                    _dropped++;
+                    continue;
+                }
+
+                count++;
+                w->pending.push_back(move(msg));
+            }
+            w->scratch.clear();
+        }
+        w->wake_cv.notify_one();
+    }
+
+    for(auto conn_id : _overflowed) {
+        spdlog::warn("[{}] connection {} has over {} pending messages, dropping", __FUNCTION__, conn_id, _max_pending_per_connection);
+        if(_overflow) {
+            _overflow(conn_id);
+        }
+    }
+    _overflowed.clear();
+}
+
+void send_pipeline::flush() {
+    for(auto &w : _workers) {
+        unique_lock lock(w->pending_mutex);
+        w->idle_cv.wait(lock, [&w] { return w->pending.empty() && !w->busy; });
+    }
+}
+
+uint32_t send_pipeline::thread_count() const noexcept {
+    return _threads.size();
+}
+
+uint64_t send_pipeline::dropped() const noexcept {
+    return _dropped;
+}
+
+void send_pipeline::worker_loop(uint32_t index) {
+    auto &w = *_workers[index];
+    vector<outward_message> sending;
+
+    while(true) {
+        {
+            unique_lock lock(w.pending_mutex);
+            w.busy = false;
+            w.idle_cv.notify_all();
+            w.wake_cv.wait(lock, [&w] { return w.quit || !w.pending.empty(); });
+
+            if(w.pending.empty()) {
+                return;
+            }
+
+            swap(sending, w.pending);
+            w.pending_counts.clear();
+            w.busy = true;
+        }
+
+        try {
+            _send(sending);
+        } catch (exception const &e) {
+            spdlog::error("[{}] sender {} threw exception {}", __FUNCTION__, index, e.what());
+        }
+        sending.clear();
+    }
+}
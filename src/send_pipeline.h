@@ -0,0 +1,83 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <messages/message.h>
+#include <lotr_flat_map.h>
+
+using namespace std;
+
+namespace lotr {
+    // Serializes and sends outward messages on dedicated threads, so the game loop only pays for handing them over.
+    // Messages for a connection always go to the same worker, which keeps their order.
+    // A connection can have at most max_pending_per_connection messages waiting for a worker. Anything over that is dropped
+    // and overflow is called with the connection id, once per backlog, so the caller can disconnect it.
+    class send_pipeline {
+    public:
+        // send gets everything a worker collected since its last call, in submission order
+        send_pipeline(uint32_t thread_count, function<void(vector<outward_message> &)> send,
+                      uint32_t max_pending_per_connection = numeric_limits<uint32_t>::max(), function<void(uint64_t)> overflow = {});
+        // sends whatever is still pending before joining
+        ~send_pipeline();
+
+        send_pipeline(send_pipeline const &) = delete;
+        send_pipeline &operator=(send_pipeline const &) = delete;
+
+        // takes the messages, leaving the vector empty. Only to be called from one thread.
+        void submit(vector<outward_message> &messages);
+        // blocks until everything submitted so far is sent
+        void flush();
+
+        [[nodiscard]]
+        uint32_t thread_count() const noexcept;
+        // messages dropped because their connection was over the cap
+        [[nodiscard]]
+        uint64_t dropped() const noexcept;
+
+    private:
+        struct worker {
+            mutex pending_mutex;
+            condition_variable wake_cv;
+            condition_variable idle_cv;
+            vector<outward_message> pending;
+            vector<outward_message> scratch;
+            // messages per connection in pending, reset when the worker takes them
+            lotr_flat_map<uint64_t, uint32_t> pending_counts;
+            bool busy = false;
+            bool quit = false;
+        };
+
+        void worker_loop(uint32_t index);
+
+        function<void(vector<outward_message> &)> _send;
+        function<void(uint64_t)> _overflow;
+        uint32_t _max_pending_per_connection;
+        uint64_t _dropped;
+        vector<uint64_t> _overflowed;
+        vector<unique_ptr<worker>> _workers;
+        vector<thread> _threads;
+    };
+}
@@ -0,0 +1,102 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "tick_clock.h"
+#include <spdlog/spdlog.h>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace std;
+using namespace lotr;
+
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+tick_clock::tick_clock(chrono::nanoseconds tick_length, chrono::nanoseconds spin_threshold) noexcept : _tick_length(tick_length), _spin_threshold(spin_threshold),
+    _next_tick(chrono::steady_clock::now() + tick_length) {
+
+}
+
+chrono::nanoseconds tick_clock::wait_for_next_tick() const {
+    auto now = chrono::steady_clock::now();
+    if(now < _next_tick - _spin_threshold) {
+        this_thread::sleep_until(_next_tick - _spin_threshold);
+    }
+
+    while((now = chrono::steady_clock::now()) < _next_tick) {
+        cpu_relax();
+    }
+
+    return now - _next_tick;
+}
+
+uint64_t tick_clock::advance(chrono::steady_clock::time_point now) noexcept {
+    _next_tick += _tick_length;
+
+    if(_tick_length.count() <= 0 || now - _next_tick <= _tick_length) {
+        return 0;
+    }
+
+    auto const dropped = static_cast<uint64_t>((now - _next_tick) / _tick_length);
+    _next_tick += dropped * _tick_length;
+    return dropped;
+}
+
+chrono::steady_clock::time_point tick_clock::next_tick() const noexcept {
+    return _next_tick;
+}
+
+#ifdef __linux__
+bool pin_to_cpu(pthread_t handle, uint32_t cpu) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+
+    auto const ret = pthread_setaffinity_np(handle, sizeof(cpu_set_t), &cpus);
+    if(ret != 0) {
+        spdlog::error("[{}] could not pin thread to cpu {}: {}", __FUNCTION__, cpu, ret);
+        return false;
+    }
+
+    return true;
+}
+
+bool lotr::pin_thread_to_cpu(thread &t, uint32_t cpu) {
+    return pin_to_cpu(t.native_handle(), cpu);
+}
+
+bool lotr::pin_current_thread_to_cpu(uint32_t cpu) {
+    return pin_to_cpu(pthread_self(), cpu);
+}
+#else
+bool lotr::pin_thread_to_cpu(thread &, uint32_t cpu) {
+    spdlog::warn("[{}] pinning threads is not supported on this platform, not pinning to cpu {}", __FUNCTION__, cpu);
+    return false;
+}
+
+bool lotr::pin_current_thread_to_cpu(uint32_t cpu) {
+    spdlog::warn("[{}] pinning threads is not supported on this platform, not pinning to cpu {}", __FUNCTION__, cpu);
+    return false;
+}
+#endif
@@ -0,0 +1,51 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <thread>
+#include <cstdint>
+
+using namespace std;
+
+namespace lotr {
+    // Schedules ticks on the monotonic steady_clock. Waiting sleeps until spin_threshold before the tick is due and spins
+    // for the rest, as sleeps regularly overshoot by tens to hundreds of µs.
+    class tick_clock {
+    public:
+        tick_clock(chrono::nanoseconds tick_length, chrono::nanoseconds spin_threshold) noexcept;
+
+        // blocks until the next tick is due, returns how late the tick starts
+        chrono::nanoseconds wait_for_next_tick() const;
+        // moves on to the tick after the current one. When now is more than a whole tick past that, the missed ticks are
+        // dropped rather than run back to back. Returns the amount of dropped ticks.
+        uint64_t advance(chrono::steady_clock::time_point now) noexcept;
+
+        [[nodiscard]] chrono::steady_clock::time_point next_tick() const noexcept;
+
+    private:
+        chrono::nanoseconds _tick_length;
+        chrono::nanoseconds _spin_threshold;
+        chrono::steady_clock::time_point _next_tick;
+    };
+
+    // returns false when pinning is not supported on this platform or failed
+    bool pin_thread_to_cpu(thread &t, uint32_t cpu);
+    bool pin_current_thread_to_cpu(uint32_t cpu);
+}
@@ -27,8 +27,10 @@
 #include <message_handlers/user_access/delete_character_handler.h>
 #include <message_handlers/user_access/character_select_handler.h>
 #include <message_handlers/commands/move_handler.h>
+#include <message_handlers/commands/resync_handler.h>
 #include <message_handlers/chat/public_chat_handler.h>
 #include <message_handlers/moderator/set_motd_handler.h>
+#include <message_handlers/protocol/negotiate_handler.h>
 #include <messages/user_access/login_request.h>
 #include <messages/user_access/register_request.h>
 #include <messages/user_access/play_character_request.h>
@@ -37,8 +39,11 @@
 #include <messages/user_access/character_select_request.h>
 #include <messages/user_access/character_select_response.h>
 #include <messages/commands/move_request.h>
+#include <messages/commands/resync_request.h>
 #include <messages/chat/message_request.h>
 #include <messages/moderator/set_motd_request.h>
+#include <messages/protocol/negotiate_request.h>
+#include <messages/binary_codec.h>
 #include <message_handlers/handler_macros.h>
 #include <messages/user_access/user_left_response.h>
 #include "per_socket_data.h"
@@ -48,7 +53,7 @@ using namespace std;
 using namespace lotr;
 
 using message_router_type = lotr_flat_map<string, function<void(server*, rapidjson::Document const &, shared_ptr<database_pool>, per_socket_data<websocketpp::connection_hdl>*,
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> &, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &)>>;
+        moodycamel::ConcurrentQueue<queue_message> &, lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> &)>>;
 
 using websocketpp::lib::placeholders::_1;
 using websocketpp::lib::placeholders::_2;
@@ -59,7 +64,7 @@ using context_ptr = websocketpp::lib::shared_ptr<websocketpp::lib::asio::ssl::co
 atomic<uint64_t> connection_id_counter = 0;
 lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> lotr::user_connections;
 lotr_flat_map<websocketpp::connection_hdl, uint64_t> handle_to_connection_id_map;
-moodycamel::ConcurrentQueue<unique_ptr<queue_message>> lotr::game_loop_queue;
+moodycamel::ConcurrentQueue<queue_message> lotr::game_loop_queue;
 string lotr::motd;
 character_select_response lotr::select_response{{}, {}, {}};
 shared_mutex lotr::user_connections_mutex;
@@ -135,8 +140,53 @@ void on_open(atomic<bool> const &quit, websocketpp::connection_hdl hdl) {
     }
 }
 
+// Handlers work on json documents. The only binary requests are the rare login and character select, so those are translated to json
+// rather than giving every handler a second entry point.
+optional<string> binary_request_as_json(string const &payload) {
+    binary_reader reader(payload);
+    binary_message_id id;
+
+    if(!reader.read_header(id)) {
+        return nullopt;
+    }
+
+    switch(id) {
+        case LoginRequest: {
+            auto request = login_request::deserialize_binary(reader);
+            if(request) {
+                return request->serialize();
+            }
+            break;
+        }
+        case CharacterSelectRequest: {
+            auto request = character_select_request::deserialize_binary(reader);
+            if(request) {
+                return request->serialize();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+
+    return nullopt;
+}
+
 void on_message(shared_ptr<database_pool> pool, message_router_type &message_router, server* s, websocketpp::connection_hdl hdl, server::message_ptr msg) {
-    string const &message = msg->get_payload();
+    string message = msg->get_payload();
+
+    if(msg->get_opcode() == websocketpp::frame::opcode::value::BINARY) {
+        auto json = binary_request_as_json(message);
+
+        if(!json) {
+            spdlog::warn("[{}] unrecognized binary message", __FUNCTION__);
+            generic_error_response resp{"Unrecognized message", "", "", true};
+            s->send(hdl, resp.serialize(), websocketpp::frame::opcode::value::TEXT);
+            return;
+        }
+
+        message = move(*json);
+    }
 
     if (message.empty() || message.length() < 4) {
         spdlog::warn("[{}] deserialize encountered empty buffer", __FUNCTION__);
@@ -210,7 +260,7 @@ void on_close(server* s, websocketpp::connection_hdl hdl) {
         }
         if (user_data->second.playing_character_slot >= 0) {
             // TODO improve performance by using queue tokens
-            game_loop_queue.enqueue(make_unique<player_leave_message>(user_data->second.connection_id));
+            game_loop_queue.enqueue(player_leave_message(user_data->second.connection_id));
         }
         if (!user_data->second.username.empty()) {
             auto same_user_id_it = find_if(begin(user_connections), end(user_connections),
@@ -258,8 +308,10 @@ void add_routes(message_router_type &message_router) {
     message_router.emplace(delete_character_request::type, handle_delete_character<server, websocketpp::connection_hdl>);
     message_router.emplace(character_select_request::type, handle_character_select<server, websocketpp::connection_hdl>);
     message_router.emplace(move_request::type, handle_move<server, websocketpp::connection_hdl>);
+    message_router.emplace(resync_request::type, handle_resync<server, websocketpp::connection_hdl>);
     message_router.emplace(message_request::type, handle_public_chat<server, websocketpp::connection_hdl>);
     message_router.emplace(set_motd_request::type, set_motd_handler<server, websocketpp::connection_hdl>);
+    message_router.emplace(negotiate_request::type, handle_negotiate<server, websocketpp::connection_hdl>);
 }
 
 thread lotr::run_uws(config const &config, shared_ptr<database_pool> pool, server_handle &s_handle, atomic<bool> &quit) {
@@ -35,7 +35,7 @@ namespace lotr {
     struct character_select_response;
 
     extern lotr_flat_map<uint64_t, per_socket_data<websocketpp::connection_hdl>> user_connections;
-    extern moodycamel::ConcurrentQueue<unique_ptr<queue_message>> game_loop_queue;
+    extern moodycamel::ConcurrentQueue<queue_message> game_loop_queue;
     extern string motd;
     extern character_select_response select_response;
     extern shared_mutex user_connections_mutex;
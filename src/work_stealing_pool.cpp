@@ -0,0 +1,144 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "work_stealing_pool.h"
+#include <spdlog/spdlog.h>
+
+using namespace std;
+using namespace lotr;
+
+work_stealing_pool::work_stealing_pool(uint32_t thread_count) : _queues(), _threads(), _task(nullptr), _remaining(0), _state_mutex(), _wake_cv(), _done_cv(), _generation(0), _quit(false) {
+    // last queue belongs to the thread calling run_and_wait
+    for(uint32_t i = 0; i <= thread_count; i++) {
+        _queues.emplace_back(make_unique<worker_queue>());
+    }
+
+    _threads.reserve(thread_count);
+    for(uint32_t i = 0; i < thread_count; i++) {
+        _threads.emplace_back(&work_stealing_pool::worker_loop, this, i);
+    }
+}
+
+work_stealing_pool::~work_stealing_pool() {
+    {
+        unique_lock lock(_state_mutex);
+        _quit = true;
+    }
+    _wake_cv.notify_all();
+
+    for(auto &t : _threads) {
+        t.join();
+    }
+}
+
+void work_stealing_pool::run_and_wait(uint32_t count, function<void(uint32_t)> const &task) {
+    if(count == 0) {
+        return;
+    }
+
+    _task = &task;
+    _remaining = count;
+
+    // hand out contiguous chunks, so neighbouring tasks start on the same thread
+    uint32_t queue_count = _queues.size();
+    uint32_t chunk = (count + queue_count - 1) / queue_count;
+    for(uint32_t q = 0; q < queue_count; q++) {
+        unique_lock lock(_queues[q]->queue_mutex);
+        for(uint32_t i = q * chunk; i < min(count, (q + 1) * chunk); i++) {
+            _queues[q]->tasks.push_back(i);
+        }
+    }
+
+    {
+        unique_lock lock(_state_mutex);
+        _generation++;
+    }
+    _wake_cv.notify_all();
+
+    run_tasks(queue_count - 1);
+
+    {
+        unique_lock lock(_state_mutex);
+        _done_cv.wait(lock, [this] { return _remaining == 0; });
+    }
+
+    _task = nullptr;
+}
+
+uint32_t work_stealing_pool::thread_count() const noexcept {
+    return _threads.size();
+}
+
+bool work_stealing_pool::try_pop(uint32_t worker, uint32_t &task) {
+    {
+        auto &own = *_queues[worker];
+        unique_lock lock(own.queue_mutex);
+        if(!own.tasks.empty()) {
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    for(uint32_t i = 1; i < _queues.size(); i++) {
+        auto &victim = *_queues[(worker + i) % _queues.size()];
+        unique_lock lock(victim.queue_mutex);
+        if(!victim.tasks.empty()) {
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void work_stealing_pool::run_tasks(uint32_t worker) {
+    uint32_t task;
+    while(try_pop(worker, task)) {
+        try {
+            (*_task)(task);
+        } catch (exception const &e) {
+            spdlog::error("[{}] task {} threw exception {}", __FUNCTION__, task, e.what());
+        }
+
+        if(--_remaining == 0) {
+            unique_lock lock(_state_mutex);
+            _done_cv.notify_all();
+        }
+    }
+}
+
+void work_stealing_pool::worker_loop(uint32_t worker) {
+    uint64_t seen_generation = 0;
+
+    while(true) {
+        {
+            unique_lock lock(_state_mutex);
+            _wake_cv.wait(lock, [this, seen_generation] { return _quit || _generation != seen_generation; });
+
+            if(_quit) {
+                return;
+            }
+
+            seen_generation = _generation;
+        }
+
+        run_tasks(worker);
+    }
+}
@@ -0,0 +1,69 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace lotr {
+    class work_stealing_pool {
+    public:
+        // thread_count is the amount of extra worker threads, the thread calling run_and_wait also executes tasks.
+        explicit work_stealing_pool(uint32_t thread_count);
+        ~work_stealing_pool();
+
+        work_stealing_pool(work_stealing_pool const &) = delete;
+        work_stealing_pool &operator=(work_stealing_pool const &) = delete;
+
+        // Runs task(0) .. task(count - 1) spread over all threads and blocks until every task is done.
+        // Each thread first works through its own queue and then steals from the others.
+        void run_and_wait(uint32_t count, function<void(uint32_t)> const &task);
+
+        [[nodiscard]]
+        uint32_t thread_count() const noexcept;
+
+    private:
+        struct worker_queue {
+            mutex queue_mutex;
+            deque<uint32_t> tasks;
+        };
+
+        bool try_pop(uint32_t worker, uint32_t &task);
+        void run_tasks(uint32_t worker);
+        void worker_loop(uint32_t worker);
+
+        vector<unique_ptr<worker_queue>> _queues;
+        vector<thread> _threads;
+        function<void(uint32_t)> const *_task;
+        atomic<uint32_t> _remaining;
+        mutex _state_mutex;
+        condition_variable _wake_cv;
+        condition_variable _done_cv;
+        uint64_t _generation;
+        bool _quit;
+    };
+}
@@ -18,25 +18,67 @@
 
 #include <catch2/catch.hpp>
 #include <ai/default_ai.h>
+#include <game_logic/logic_helpers.h>
+#include <game_logic/spawners.h>
 
 using namespace std;
 using namespace lotr;
 
-vector<pc_component*> get_players_in_range(character_component const &npc, map_component const &m, lotr_player_location_map const &player_location_map, int32_t radius);
+vector<entt::entity> get_players_in_range(location const &loc, map_component &m, int32_t radius);
 
 TEST_CASE("default ai tests") {
-    lotr_player_location_map locations;
-    pc_component pc;
-    npc_component npc;
-    npc.loc = make_tuple(3, 3);
+    auto npc_loc = make_tuple(3, 3);
     map_component m(10, 10, "test", {}, {}, {});
-    locations[make_tuple(1,1)].push_back(&pc);
+    auto player = add_player(m, make_tuple(1, 1), appearance_component(1, "", 0), 1, pc_component());
 
-    auto pcs_in_range = get_players_in_range(npc, m, locations, 1);
+    auto pcs_in_range = get_players_in_range(npc_loc, m, 1);
 
     REQUIRE(pcs_in_range.empty());
 
-    pcs_in_range = get_players_in_range(npc, m, locations, 2);
+    pcs_in_range = get_players_in_range(npc_loc, m, 2);
 
     REQUIRE(pcs_in_range.size() == 1);
+    REQUIRE(pcs_in_range[0] == player);
+}
+
+TEST_CASE("coarse ai leashes like the full ai") {
+    map_component m(40, 40, "test", {}, {}, {});
+    spawner_script script;
+    script.loc = make_tuple(20, 20);
+    script.random_walk_radius = 5;
+    script.leash_radius = 10;
+    auto spawner = add_spawner(m, script);
+
+    // stays put, walked too far and leashes home, strayed past leash_radius + 4 and also heals
+    for(auto const &start : {make_tuple(22, 20), make_tuple(26, 20), make_tuple(35, 20)}) {
+        vector<entt::entity> npcs;
+        for(uint32_t i = 0; i < 2; i++) {
+            npc_component npc;
+            npc.stats[StatMove] = 0;
+            npc.stats[StatHp] = 3;
+            npc.stats[StatMaxHp] = 10;
+            npc.stats[StatMp] = 1;
+            npc.stats[StatMaxMp] = 10;
+            npcs.push_back(add_npc(m, start, appearance_component(i, "", 0), ai_component(), spawner, move(npc)));
+        }
+
+        run_ai_on(m.entities.get<position_component>(npcs[0]), m.entities.get<vitals_component>(npcs[0]), m.entities.get<ai_component>(npcs[0]),
+                  m.entities.get<spawner_link_component>(npcs[0]), m.entities.get<npc_component>(npcs[0]), m);
+        run_coarse_ai_on(m.entities.get<position_component>(npcs[1]), m.entities.get<vitals_component>(npcs[1]), m.entities.get<ai_component>(npcs[1]),
+                         m.entities.get<spawner_link_component>(npcs[1]), m);
+
+        auto const &full_vitals = m.entities.get<vitals_component>(npcs[0]);
+        auto const &coarse_vitals = m.entities.get<vitals_component>(npcs[1]);
+        REQUIRE(m.entities.get<position_component>(npcs[0]).loc == m.entities.get<position_component>(npcs[1]).loc);
+        REQUIRE(full_vitals.hp == coarse_vitals.hp);
+        REQUIRE(full_vitals.mp == coarse_vitals.mp);
+
+        auto const healed = start == make_tuple(35, 20);
+        REQUIRE(m.entities.get<position_component>(npcs[1]).loc == (start == make_tuple(22, 20) ? start : script.loc));
+        REQUIRE(coarse_vitals.hp == (healed ? 10 : 3));
+        REQUIRE(coarse_vitals.mp == (healed ? 10 : 1));
+
+        remove_npc(m, npcs[0]);
+        remove_npc(m, npcs[1]);
+    }
 }
@@ -124,7 +124,7 @@ TEST_CASE("map_loading tests") {
     lotr_flat_map <string, optional<spawner_script>> spawner_script_cache;
     auto gnpc_entity = registry.create();
     global_npc_component gnpc;
-    gnpc.npc_id = "Tutorial Townee";
+    gnpc.npc_id = interned_string("Tutorial Townee");
     registry.assign<global_npc_component>(gnpc_entity, gnpc);
 
     auto map = load_map_from_file("test_map.json", registry, spawner_script_cache);
@@ -154,7 +154,8 @@ TEST_CASE("map_loading tests") {
     REQUIRE(map->layers[map_layer_name::Spawners].y == 0);
     REQUIRE(map->layers[map_layer_name::Spawners].name == "Spawners"s);
     REQUIRE(map->layers[map_layer_name::Spawners].type == "objectgroup"s);
-    REQUIRE(map->layers[map_layer_name::Spawners].objects.size() == 48*48);
+    REQUIRE(map->layers[map_layer_name::Spawners].objects.size() == 1);
+    REQUIRE(map->layers[map_layer_name::Spawners].objects.tile_count() == 48*48);
     REQUIRE(map->layers[map_layer_name::Spawners].data.size() == 0);
 
     REQUIRE(map->layers[map_layer_name::NPCs].width == 48);
@@ -163,10 +164,14 @@ TEST_CASE("map_loading tests") {
     REQUIRE(map->layers[map_layer_name::NPCs].y == 0);
     REQUIRE(map->layers[map_layer_name::NPCs].name == "NPCs"s);
     REQUIRE(map->layers[map_layer_name::NPCs].type == "objectgroup"s);
-    REQUIRE(map->layers[map_layer_name::NPCs].objects.size() == 48*48);
+    REQUIRE(map->layers[map_layer_name::NPCs].objects.size() == 1);
+    REQUIRE(map->layers[map_layer_name::NPCs].objects.tile_count() == 48*48);
     REQUIRE(map->layers[map_layer_name::NPCs].data.size() == 0);
 
-    auto const &object = map->layers[map_layer_name::Spawners].objects[1472/64 + (2176 - 64)/64 * 48];
+    REQUIRE(map->layers[map_layer_name::Spawners].objects.occupied(1472/64 + (2176 - 64)/64 * 48));
+    REQUIRE(!map->layers[map_layer_name::Spawners].objects.occupied(0));
+    REQUIRE(map->layers[map_layer_name::Spawners].objects.find(0) == nullptr);
+    auto const &object = *map->layers[map_layer_name::Spawners].objects.find(1472/64 + (2176 - 64)/64 * 48);
     REQUIRE(object.gid == 3182);
     REQUIRE(object.id == 174);
     REQUIRE(object.width == 64);
@@ -177,7 +182,8 @@ TEST_CASE("map_loading tests") {
     REQUIRE(object.properties[0].name == "script");
     REQUIRE(get<string>(object.properties[0].value) == "tutorial/townee");
 
-    auto const &object2 = map->layers[map_layer_name::NPCs].objects[1536/64 + (2240 - 64)/64 * 48];
+    REQUIRE(map->layers[map_layer_name::NPCs].objects.occupied(1536/64 + (2240 - 64)/64 * 48));
+    auto const &object2 = *map->layers[map_layer_name::NPCs].objects.find(1536/64 + (2240 - 64)/64 * 48);
     REQUIRE(object2.gid == 3183);
     REQUIRE(object2.id == 175);
     REQUIRE(object2.width == 64);
@@ -190,7 +196,7 @@ TEST_CASE("map_loading tests") {
 
     REQUIRE(object.script);
     REQUIRE(object.script->npc_ids.size() == 1);
-    REQUIRE(object.script->npc_ids[0].npc_id == "Tutorial Townee");
+    REQUIRE(object.script->npc_ids[0].npc_id.str() == "Tutorial Townee");
     REQUIRE(object.script->npc_ids[0].chance == 1);
     REQUIRE(object.script->respawn_rate == 15);
     REQUIRE(object.script->initial_spawn == 2);
@@ -19,7 +19,13 @@
 #include <catch2/catch.hpp>
 #include <spdlog/spdlog.h>
 #include "test_helpers/startup_helper.h"
+#include "test_helpers/fov_reference.h"
 #include "game_logic/fov.h"
+#include "game_logic/fov_table.h"
+#include <sstream>
+#include <cstring>
+#include <random>
+#include <thread>
 #include <ecs/components.h>
 
 using namespace std;
@@ -188,4 +194,229 @@ TEST_CASE("fov tests") {
         check_fov = bitset<power(fov_diameter)>("000000000000000000000000000000000000000011111000011111000011111000011111000011111"s);
         REQUIRE(fov == check_fov);
     }
+
+    SECTION("precomputed table matches live fov") {
+        const uint32_t map_size = 30;
+        array<map_layer, 15> map_layers;
+        vector<uint32_t> wall_data(map_size*map_size);
+        vector<map_object> object_data(map_size*map_size);
+
+        for(uint32_t i = 0; i < map_size*map_size; i++) {
+            if(i % 7 == 0 || i % 11 == 3) {
+                wall_data[i] = 1;
+            }
+            if(i % 13 == 5) {
+                object_data[i] = map_object(1, 0, 64, 64, "test"s, "test"s, vector<map_property>{}, nullopt);
+            }
+        }
+
+        map_layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "wall_layer_name", "tilelayer"s, vector<map_object>{}, wall_data);
+        map_layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque_layer_name", "objectgroup"s, object_data, vector<uint32_t>{});
+
+        map_component m(map_size, map_size, "test"s, {}, map_layers, {});
+        auto table = fov_table::build(m);
+        REQUIRE(table.matches(m));
+
+        stringstream persisted;
+        table.save(persisted);
+        fov_table loaded;
+        auto const persisted_table = persisted.str();
+        REQUIRE(loaded.load(persisted, m));
+        REQUIRE(loaded.matches(m));
+
+        for(int32_t y = 0; y < static_cast<int32_t>(map_size); y++) {
+            for(int32_t x = 0; x < static_cast<int32_t>(map_size); x++) {
+                if(wall_data[x + y * map_size] != 0 || object_data[x + y * map_size].gid != 0) {
+                    continue;
+                }
+
+                auto loc = make_tuple(x, y);
+                auto fov = compute_fov_restrictive_shadowcasting(m, loc, true);
+                REQUIRE(table.lookup(loc) == fov);
+                REQUIRE(loaded.lookup(loc) == fov);
+            }
+        }
+
+        m.fov_cache = move(loaded);
+        auto loc = make_tuple(2, 1);
+        REQUIRE(get_fov(m, loc) == compute_fov_restrictive_shadowcasting(m, loc, true));
+
+        // unwalkable tiles aren't in the table
+        auto wall_loc = make_tuple(0, 0);
+        REQUIRE(wall_data[0] != 0);
+        REQUIRE(get_fov(m, wall_loc).any());
+        REQUIRE(get_fov(m, wall_loc) == compute_fov_restrictive_shadowcasting(m, wall_loc, true));
+
+        // a header claiming a huge map is rejected before reading the tiles
+        auto huge = persisted_table;
+        uint32_t const huge_size = 0xFFFF'FFFFU;
+        memcpy(&huge[8 + sizeof(uint32_t)], &huge_size, sizeof(huge_size));
+        memcpy(&huge[8 + 2 * sizeof(uint32_t)], &huge_size, sizeof(huge_size));
+        stringstream huge_stream(huge);
+        fov_table rejected;
+        REQUIRE(!rejected.load(huge_stream, m));
+        REQUIRE(rejected.empty());
+
+        m.layers[map_layer_name::Walls].data.set(0, m.layers[map_layer_name::Walls].data[0] ^ 1U);
+        REQUIRE(!table.matches(m));
+
+        stringstream garbage("not a fov table");
+        REQUIRE(!loaded.load(garbage, m));
+    }
+
+    SECTION("fixed point matches the double kernel on open maps") {
+        const uint32_t map_size = 20;
+        array<map_layer, 15> map_layers;
+        vector<uint32_t> wall_data(map_size*map_size);
+        vector<map_object> object_data(map_size*map_size);
+
+        map_layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "wall_layer_name", "tilelayer"s, vector<map_object>{}, wall_data);
+        map_layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque_layer_name", "objectgroup"s, object_data, vector<uint32_t>{});
+
+        map_component m(map_size, map_size, "test"s, {}, map_layers, {});
+        fov_scratch scratch;
+
+        for(int32_t y = 0; y < static_cast<int32_t>(map_size); y++) {
+            for(int32_t x = 0; x < static_cast<int32_t>(map_size); x++) {
+                auto loc = make_tuple(x, y);
+                REQUIRE(compute_fov_restrictive_shadowcasting(m, loc, true, scratch) == compute_fov_double_reference(m, loc, true));
+                REQUIRE(compute_fov_restrictive_shadowcasting(m, loc, false, scratch) == compute_fov_double_reference(m, loc, false));
+            }
+        }
+    }
+
+    SECTION("known tie differences with the double kernel") {
+        // A lone wall a knight's move away puts the edge of its shadow exactly on a slope of the tile at (3, 4) or (4, 3).
+        // The double kernel works with thirds and sixths that don't round exactly and sees that tile, exact slopes keep it in the shadow.
+        struct tie_case {
+            location wall_offset;
+            location hidden_tile;
+        };
+        vector<tie_case> const known_ties{
+            {make_tuple(1, 2), make_tuple(3, 4)}, {make_tuple(-1, 2), make_tuple(-3, 4)},
+            {make_tuple(1, -2), make_tuple(3, -4)}, {make_tuple(-1, -2), make_tuple(-3, -4)},
+            {make_tuple(2, 1), make_tuple(4, 3)}, {make_tuple(-2, 1), make_tuple(-4, 3)},
+            {make_tuple(2, -1), make_tuple(4, -3)}, {make_tuple(-2, -1), make_tuple(-4, -3)},
+        };
+
+        const uint32_t map_size = 20;
+        auto const wall = make_tuple(10, 10);
+        array<map_layer, 15> map_layers;
+        vector<uint32_t> wall_data(map_size*map_size);
+        vector<map_object> object_data(map_size*map_size);
+        wall_data[get<0>(wall) + get<1>(wall) * map_size] = 1;
+
+        map_layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "wall_layer_name", "tilelayer"s, vector<map_object>{}, wall_data);
+        map_layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque_layer_name", "objectgroup"s, object_data, vector<uint32_t>{});
+
+        map_component m(map_size, map_size, "test"s, {}, map_layers, {});
+        fov_scratch scratch;
+        uint32_t ties_seen = 0;
+
+        for(int32_t y = 0; y < static_cast<int32_t>(map_size); y++) {
+            for(int32_t x = 0; x < static_cast<int32_t>(map_size); x++) {
+                auto loc = make_tuple(x, y);
+                auto const wall_offset = make_tuple(get<0>(wall) - x, get<1>(wall) - y);
+                auto tie = find_if(begin(known_ties), end(known_ties), [&](tie_case const &c) { return c.wall_offset == wall_offset; });
+
+                for(bool light_walls : {true, false}) {
+                    auto fixed = compute_fov_restrictive_shadowcasting(m, loc, light_walls, scratch);
+                    auto reference = compute_fov_double_reference(m, loc, light_walls);
+
+                    if(tie == end(known_ties)) {
+                        REQUIRE(fixed == reference);
+                        continue;
+                    }
+
+                    auto const tile = get<0>(tie->hidden_tile) + fov_max_distance + (get<1>(tie->hidden_tile) + fov_max_distance) * fov_diameter;
+                    REQUIRE(reference[tile]);
+                    REQUIRE(!fixed[tile]);
+                    reference[tile] = false;
+                    REQUIRE(fixed == reference);
+                    ties_seen++;
+                }
+            }
+        }
+
+        REQUIRE(ties_seen == known_ties.size() * 2);
+    }
+
+    SECTION("concurrent callers with their own scratch") {
+        const uint32_t map_size = 30;
+        array<map_layer, 15> map_layers;
+        vector<uint32_t> wall_data(map_size*map_size);
+        vector<map_object> object_data(map_size*map_size);
+
+        for(uint32_t i = 0; i < map_size*map_size; i++) {
+            if(i % 7 == 0 || i % 11 == 3) {
+                wall_data[i] = 1;
+            }
+        }
+
+        map_layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "wall_layer_name", "tilelayer"s, vector<map_object>{}, wall_data);
+        map_layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque_layer_name", "objectgroup"s, object_data, vector<uint32_t>{});
+
+        map_component m(map_size, map_size, "test"s, {}, map_layers, {});
+
+        vector<bitset<power(fov_diameter)>> expected;
+        for(uint32_t i = 0; i < map_size*map_size; i++) {
+            expected.push_back(compute_fov_restrictive_shadowcasting(m, make_tuple(i % map_size, i / map_size), true));
+        }
+
+        atomic<uint32_t> mismatches{0};
+        vector<thread> threads;
+        for(uint32_t t = 0; t < 4; t++) {
+            threads.emplace_back([&m, &expected, &mismatches, t]() {
+                fov_scratch scratch;
+                for(uint32_t round = 0; round < 20; round++) {
+                    for(uint32_t i = t; i < map_size*map_size; i += 4) {
+                        if(compute_fov_restrictive_shadowcasting(m, make_tuple(i % map_size, i / map_size), true, scratch) != expected[i]) {
+                            mismatches++;
+                        }
+                    }
+                }
+            });
+        }
+        for(auto &t : threads) {
+            t.join();
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+
+    SECTION("batch matches single fov") {
+        const uint32_t map_size = 30;
+        array<map_layer, 15> map_layers;
+        vector<uint32_t> wall_data(map_size*map_size);
+        vector<map_object> object_data(map_size*map_size);
+
+        for(uint32_t i = 0; i < map_size*map_size; i++) {
+            if(i % 7 == 0 || i % 11 == 3) {
+                wall_data[i] = 1;
+            }
+        }
+
+        map_layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "wall_layer_name", "tilelayer"s, vector<map_object>{}, wall_data);
+        map_layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque_layer_name", "objectgroup"s, object_data, vector<uint32_t>{});
+
+        map_component m(map_size, map_size, "test"s, {}, map_layers, {});
+
+        vector<location> observers{make_tuple(5, 5), make_tuple(2, 1), make_tuple(5, 5), make_tuple(29, 29), make_tuple(2, 1), make_tuple(5, 5), make_tuple(6, 5)};
+        vector<bitset<power(fov_diameter)>> fovs;
+
+        get_fov_batch(m, observers, fovs);
+        REQUIRE(fovs.size() == observers.size());
+        for(uint32_t i = 0; i < observers.size(); i++) {
+            REQUIRE(fovs[i] == get_fov(m, observers[i]));
+        }
+
+        m.fov_cache = fov_table::build(m);
+        get_fov_batch(m, observers, fovs);
+        for(uint32_t i = 0; i < observers.size(); i++) {
+            REQUIRE(fovs[i] == compute_fov_restrictive_shadowcasting(m, observers[i], true));
+        }
+
+        get_fov_batch(m, {}, fovs);
+        REQUIRE(fovs.empty());
+    }
 }
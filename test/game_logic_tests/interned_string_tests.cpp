@@ -0,0 +1,64 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("interned identifier tests") {
+    SECTION("equal strings share an id") {
+        interned_string a("interned_test_orc");
+        interned_string b(string("interned_test_") + "orc");
+        interned_string c("interned_test_goblin");
+
+        REQUIRE(a == b);
+        REQUIRE(a != c);
+        REQUIRE(a.str() == "interned_test_orc");
+        REQUIRE(c.str() == "interned_test_goblin");
+    }
+
+    SECTION("empty string is id 0") {
+        interned_string empty;
+        REQUIRE(empty.empty());
+        REQUIRE(empty.id() == 0);
+        REQUIRE(interned_string("") == empty);
+        REQUIRE(empty.str().empty());
+    }
+
+    SECTION("find does not intern") {
+        REQUIRE(!interned_string::find("interned_test_never_added"));
+        interned_string added("interned_test_added");
+        auto found = interned_string::find("interned_test_added");
+        REQUIRE(found);
+        REQUIRE(*found == added);
+    }
+
+    SECTION("hostility and direction parse") {
+        REQUIRE(hostility_from_string("never") == HostilityNever);
+        REQUIRE(hostility_from_string("onHit") == HostilityOnHit);
+        REQUIRE(hostility_from_string("faction") == HostilityFaction);
+        REQUIRE(hostility_from_string("always") == HostilityAlways);
+        REQUIRE(!hostility_from_string("sometimes"));
+
+        REQUIRE(direction_from_string(north_direction) == North);
+        REQUIRE(direction_from_string(south_west_direction) == SouthWest);
+        REQUIRE(!direction_from_string("up"));
+    }
+}
@@ -0,0 +1,85 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <game_logic/map_delta.h>
+#include <ecs/components.h>
+#include <messages/map_update_response.h>
+#include <messages/map_delta_response.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("map delta tests") {
+    connection_component player(1);
+    appearance_component a(1, "", 10);
+    appearance_component b(2, "", 20);
+    vector<visible_entity> visible{{&a, make_tuple(1, 1)}, {&b, make_tuple(2, 2)}};
+
+    auto update = create_map_update(player, visible, 10);
+    REQUIRE(dynamic_cast<map_update_response*>(update.get()) != nullptr);
+    REQUIRE(dynamic_cast<map_update_response*>(update.get())->npcs.size() == 2);
+
+    SECTION("nothing changed sends nothing") {
+        REQUIRE(create_map_update(player, visible, 10) == nullptr);
+    }
+
+    SECTION("entered, changed, moved and left") {
+        appearance_component c(3, "", 0);
+        b.sprite = 21;
+        vector<visible_entity> next{{&a, make_tuple(1, 2)}, {&b, make_tuple(2, 2)}, {&c, make_tuple(3, 3)}};
+
+        update = create_map_update(player, next, 10);
+        auto *delta = dynamic_cast<map_delta_response*>(update.get());
+        REQUIRE(delta != nullptr);
+        REQUIRE(delta->entered.size() == 1);
+        REQUIRE(delta->entered[0].id == 3);
+        REQUIRE(delta->changed.size() == 1);
+        REQUIRE(delta->changed[0].id == 2);
+        REQUIRE(delta->changed[0].sprite == 21);
+        REQUIRE(delta->moved.size() == 1);
+        REQUIRE(delta->moved[0].id == 1);
+        REQUIRE(delta->moved[0].loc == make_tuple(1, 2));
+        REQUIRE(delta->left.empty());
+
+        vector<visible_entity> only_c{{&c, make_tuple(3, 3)}};
+        update = create_map_update(player, only_c, 10);
+        delta = dynamic_cast<map_delta_response*>(update.get());
+        REQUIRE(delta != nullptr);
+        REQUIRE(delta->left.size() == 2);
+        REQUIRE(player.sent_entities.size() == 1);
+    }
+
+    SECTION("keyframe interval and resync") {
+        for(uint32_t i = 1; i < 10; i++) {
+            REQUIRE(create_map_update(player, visible, 10) == nullptr);
+        }
+        update = create_map_update(player, visible, 10);
+        REQUIRE(dynamic_cast<map_update_response*>(update.get()) != nullptr);
+
+        player.keyframe_requested = true;
+        update = create_map_update(player, visible, 10);
+        REQUIRE(dynamic_cast<map_update_response*>(update.get()) != nullptr);
+        REQUIRE(create_map_update(player, visible, 10) == nullptr);
+    }
+
+    SECTION("interval of 0 always sends full updates") {
+        update = create_map_update(player, visible, 0);
+        REQUIRE(dynamic_cast<map_update_response*>(update.get()) != nullptr);
+    }
+}
@@ -0,0 +1,257 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <game_logic/logic_helpers.h>
+#include <ai/default_ai.h>
+#include <game_logic/map_tick.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("map entity tests") {
+    map_component m(20, 20, "test", {}, {}, {});
+    vector<entt::entity> npcs;
+    for(int32_t i = 0; i < 4; i++) {
+        npc_component npc;
+        npc.stats[StatHp] = npc.stats[StatMaxHp] = 10;
+        npcs.push_back(add_npc(m, make_tuple(i, i), appearance_component(i, "", 0), ai_component(), entt::null, move(npc)));
+    }
+    auto player = add_player(m, make_tuple(5, 5), appearance_component(10, "player", 0), 1, pc_component());
+
+    SECTION("npc group only contains npcs") {
+        uint32_t count = 0;
+        npc_group(m).each([&](entt::entity npc, position_component &, vitals_component &vitals, ai_component &, spawner_link_component &, npc_component &) {
+            REQUIRE(npc != player);
+            REQUIRE(vitals.hp == 10);
+            count++;
+        });
+        REQUIRE(count == 4);
+    }
+
+    SECTION("dead npcs are destroyed and leave the grid") {
+        m.entities.get<vitals_component>(npcs[1]).hp = 0;
+        m.entities.get<vitals_component>(npcs[3]).hp = -5;
+        remove_dead_npcs(m);
+
+        REQUIRE(m.entities.valid(npcs[0]));
+        REQUIRE(!m.entities.valid(npcs[1]));
+        REQUIRE(m.entities.valid(npcs[2]));
+        REQUIRE(!m.entities.valid(npcs[3]));
+        REQUIRE(m.npc_grid.size() == 2);
+        REQUIRE(m.entities.valid(player));
+    }
+
+    SECTION("handles to destroyed entities stay invalid after their slot is reused") {
+        auto stale = npcs[0];
+        remove_npc(m, stale);
+        auto reused = add_npc(m, make_tuple(9, 9), appearance_component(20, "", 0), ai_component(), entt::null, npc_component());
+
+        REQUIRE(!m.entities.valid(stale));
+        REQUIRE(m.entities.valid(reused));
+        REQUIRE(reused != stale);
+    }
+
+    SECTION("spawner handles") {
+        spawner_script script;
+        script.loc = make_tuple(2, 2);
+        script.max_creatures = 1;
+        auto spawner = add_spawner(m, script);
+        REQUIRE(get_spawner(m, spawner) != nullptr);
+        REQUIRE(get_spawner(m, spawner)->loc == make_tuple(2, 2));
+        REQUIRE(get_spawner(m, entt::null) == nullptr);
+
+        m.entities.destroy(spawner);
+        REQUIRE(get_spawner(m, spawner) == nullptr);
+    }
+
+    SECTION("ai drops targets that are gone") {
+        auto &ai = m.entities.get<ai_component>(npcs[0]);
+        ai.hostility = HostilityNever;
+        ai.agro_target = npcs[1];
+        remove_npc(m, npcs[1]);
+
+        run_ai_on(m.entities.get<position_component>(npcs[0]), m.entities.get<vitals_component>(npcs[0]), ai, m.entities.get<spawner_link_component>(npcs[0]),
+                  m.entities.get<npc_component>(npcs[0]), m);
+        REQUIRE(ai.agro_target == static_cast<entt::entity>(entt::null));
+    }
+
+    SECTION("npcs act on their action interval") {
+        npc_component npc;
+        REQUIRE(ai_action_interval(npc, 1'000) == 1);
+        REQUIRE(ai_action_interval(npc, 250) == 4);
+        npc.stats[StatActionSpeed] = 1;
+        REQUIRE(ai_action_interval(npc, 250) == 2);
+        npc.stats[StatActionSpeed] = 10;
+        REQUIRE(ai_action_interval(npc, 250) == 1);
+
+        lotr_flat_map<entt::entity, uint32_t> actions;
+        for(uint32_t i = 0; i < 20; i++) {
+            m.tick++;
+            run_timers(m);
+            for(auto due : m.pending_ai) {
+                actions[due]++;
+            }
+            run_pending_ai(m, chrono::steady_clock::time_point::max());
+        }
+
+        REQUIRE(actions.size() == 4);
+        REQUIRE(actions[npcs[0]] == 20);
+
+        m.tick_length = 250;
+        m.entities.get<npc_component>(npcs[1]).stats[StatActionSpeed] = 1;
+        actions.clear();
+        for(uint32_t i = 0; i < 20; i++) {
+            m.tick++;
+            run_timers(m);
+            for(auto due : m.pending_ai) {
+                actions[due]++;
+            }
+            run_pending_ai(m, chrono::steady_clock::time_point::max());
+        }
+
+        REQUIRE(actions[npcs[0]] == 5);
+        REQUIRE(actions[npcs[1]] == 10);
+        REQUIRE(actions.find(player) == end(actions));
+    }
+
+    SECTION("first ai action falls within the first interval") {
+        // default tick length gives an interval of 1, which has to act on the next tick
+        auto const start = m.tick;
+        for(uint32_t i = 0; i < 4; i++) {
+            m.tick++;
+            run_timers(m);
+            if(m.tick == start + 1) {
+                REQUIRE(m.pending_ai.size() == 4);
+            }
+            m.pending_ai.clear();
+        }
+
+        m.tick_length = 100;
+        auto const spawn_tick = m.tick;
+        vector<entt::entity> spawned;
+        for(uint32_t i = 0; i < 200; i++) {
+            spawned.push_back(add_npc(m, make_tuple(10, 10), appearance_component(i, "", 0), ai_component(), entt::null, npc_component()));
+        }
+        auto const interval = ai_action_interval(npc_component(), m.tick_length);
+        REQUIRE(interval == 10);
+
+        lotr_flat_map<entt::entity, uint64_t> first_action;
+        for(uint32_t i = 0; i < interval + 1; i++) {
+            m.tick++;
+            run_timers(m);
+            for(auto due : m.pending_ai) {
+                first_action.emplace(due, m.tick);
+            }
+            m.pending_ai.clear();
+        }
+
+        lotr_flat_map<uint64_t, uint32_t> per_tick;
+        for(auto npc : spawned) {
+            REQUIRE(first_action.find(npc) != end(first_action));
+            REQUIRE(first_action[npc] >= spawn_tick + 1);
+            REQUIRE(first_action[npc] <= spawn_tick + interval);
+            per_tick[first_action[npc]]++;
+        }
+        REQUIRE(per_tick.size() > 1);
+    }
+
+    SECTION("removed npcs stop acting") {
+        remove_npc(m, npcs[0]);
+        REQUIRE(!m.timers.is_scheduled(npcs[0], AiTimer));
+        REQUIRE(m.timers.is_scheduled(npcs[1], AiTimer));
+    }
+
+    SECTION("npcs away from players only get the coarse update until a player comes near") {
+        m.ai_full_radius = 2;
+        m.tick++;
+        run_timers(m);
+        REQUIRE(m.pending_ai.size() == 4);
+        run_pending_ai(m, chrono::steady_clock::time_point::max());
+
+        REQUIRE(m.entities.get<ai_component>(npcs[0]).coarse);
+        REQUIRE(m.entities.get<ai_component>(npcs[2]).coarse);
+        REQUIRE(!m.entities.get<ai_component>(npcs[3]).coarse);
+
+        m.tick++;
+        run_timers(m);
+        REQUIRE(m.pending_ai == vector<entt::entity>{npcs[3]});
+        run_pending_ai(m, chrono::steady_clock::time_point::max());
+
+        move_player(m, player, make_tuple(0, 0));
+        REQUIRE(!m.entities.get<ai_component>(npcs[0]).coarse);
+        m.tick++;
+        run_timers(m);
+        auto due = m.pending_ai;
+        sort(begin(due), end(due));
+        REQUIRE(due == vector<entt::entity>{npcs[0], npcs[1], npcs[2], npcs[3]});
+    }
+
+    SECTION("ai past the deadline continues next tick where it left off") {
+        for(int32_t i = 0; i < 36; i++) {
+            add_npc(m, make_tuple(i % 20, i / 20), appearance_component(100 + i, "", 0), ai_component(), entt::null, npc_component());
+        }
+
+        m.tick++;
+        run_timers(m);
+        REQUIRE(m.pending_ai.size() == 40);
+        auto const oldest_left = m.pending_ai[16];
+
+        auto const expired = chrono::steady_clock::now();
+        REQUIRE(run_pending_ai(m, expired) == 24);
+        REQUIRE(m.pending_ai.front() == oldest_left);
+        REQUIRE(!m.timers.is_scheduled(oldest_left, AiTimer));
+
+        // newly due npcs queue up behind the ones left over
+        m.tick++;
+        run_timers(m);
+        REQUIRE(m.pending_ai.size() == 40);
+        REQUIRE(m.pending_ai.front() == oldest_left);
+
+        REQUIRE(run_pending_ai(m, chrono::steady_clock::time_point::max()) == 0);
+        REQUIRE(m.deferred_work == 24);
+        REQUIRE(m.timers.is_scheduled(oldest_left, AiTimer));
+    }
+
+    SECTION("waking a coarse npc that is still pending does not run it twice") {
+        m.ai_full_radius = 2;
+        m.tick++;
+        run_timers(m);
+        run_pending_ai(m, chrono::steady_clock::time_point::max());
+        REQUIRE(m.entities.get<ai_component>(npcs[0]).coarse);
+
+        // let the coarse timer of npcs[0] fire, but leave it pending past the deadline
+        while(find(begin(m.pending_ai), end(m.pending_ai), npcs[0]) == end(m.pending_ai)) {
+            m.tick++;
+            run_timers(m);
+        }
+        REQUIRE(m.entities.get<ai_component>(npcs[0]).pending);
+
+        move_player(m, player, make_tuple(0, 0));
+        REQUIRE(!m.entities.get<ai_component>(npcs[0]).coarse);
+        REQUIRE(!m.timers.is_scheduled(npcs[0], AiTimer));
+
+        run_pending_ai(m, chrono::steady_clock::time_point::max());
+        REQUIRE(!m.entities.get<ai_component>(npcs[0]).pending);
+        REQUIRE(m.timers.is_scheduled(npcs[0], AiTimer));
+
+        m.tick++;
+        run_timers(m);
+        REQUIRE(count(begin(m.pending_ai), end(m.pending_ai), npcs[0]) == 1);
+    }
+}
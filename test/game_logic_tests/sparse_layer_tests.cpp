@@ -0,0 +1,86 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <game_logic/sparse_layer.h>
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("sparse layer tests") {
+    SECTION("insert out of order keeps tile order") {
+        sparse_layer<uint32_t> layer(10, 10);
+        layer.insert(55, 1);
+        layer.insert(3, 2);
+        layer.insert(99, 3);
+        layer.insert(20, 4);
+
+        REQUIRE(layer.size() == 4);
+        REQUIRE(layer.tile_count() == 100);
+        REQUIRE(vector<uint32_t>(begin(layer), end(layer)) == vector<uint32_t>{2, 4, 1, 3});
+        REQUIRE(layer.index_at(0) == 3);
+        REQUIRE(layer.index_at(3) == 99);
+    }
+
+    SECTION("occupancy and lookups") {
+        sparse_layer<uint32_t> layer(10, 10);
+        layer.insert(64, 7);
+        layer.insert(63, 8);
+
+        REQUIRE(layer.occupied(63));
+        REQUIRE(layer.occupied(64));
+        REQUIRE(!layer.occupied(65));
+        REQUIRE(!layer.occupied(100));
+        REQUIRE(!layer.occupied(5'000));
+        REQUIRE(*layer.find(64) == 7);
+        REQUIRE(*layer.find(63) == 8);
+        REQUIRE(layer.find(0) == nullptr);
+
+        *layer.find(64) = 9;
+        layer.insert(63, 10);
+        REQUIRE(layer.size() == 2);
+        REQUIRE(*layer.find(64) == 9);
+        REQUIRE(*layer.find(63) == 10);
+    }
+
+    SECTION("out of bounds inserts are rejected") {
+        sparse_layer<uint32_t> layer(10, 10);
+        REQUIRE_THROWS_AS(layer.insert(100, 1), out_of_range);
+        REQUIRE_THROWS_AS(layer.insert(5'000, 1), out_of_range);
+        REQUIRE(layer.empty());
+
+        sparse_layer<uint32_t> empty_layer;
+        REQUIRE_THROWS_AS(empty_layer.insert(0, 1), out_of_range);
+    }
+
+    SECTION("map layer from dense objects skips empty tiles") {
+        vector<map_object> objects(4 * 4);
+        objects[5].gid = 12;
+        objects[9].id = 3;
+
+        map_layer layer(0, 0, 4, 4, "opaque", "objectgroup"s, move(objects), vector<uint32_t>{});
+
+        REQUIRE(layer.objects.size() == 2);
+        REQUIRE(layer.objects.occupied(5));
+        REQUIRE(layer.objects.find(5)->gid == 12);
+        REQUIRE(layer.objects.find(9)->id == 3);
+        REQUIRE(!layer.objects.occupied(0));
+    }
+}
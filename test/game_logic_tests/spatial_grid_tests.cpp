@@ -0,0 +1,113 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <game_logic/spatial_grid.h>
+#include <game_logic/logic_helpers.h>
+
+using namespace std;
+using namespace lotr;
+
+vector<uint32_t> ids_in_window(spatial_grid const &grid, int32_t min_x, int32_t min_y, int32_t max_x, int32_t max_y) {
+    vector<uint32_t> ret;
+    grid.for_each_in_window(min_x, min_y, max_x, max_y, [&](entt::entity entity, location const &) { ret.push_back(static_cast<uint32_t>(entity)); });
+    sort(begin(ret), end(ret));
+    return ret;
+}
+
+TEST_CASE("spatial grid tests") {
+    SECTION("window query is exact across cells") {
+        spatial_grid grid(40, 40);
+        grid.insert(entt::entity{0}, make_tuple(7, 7));
+        grid.insert(entt::entity{1}, make_tuple(8, 8));
+        grid.insert(entt::entity{2}, make_tuple(12, 3));
+        grid.insert(entt::entity{3}, make_tuple(39, 39));
+
+        REQUIRE(grid.size() == 4);
+        REQUIRE(ids_in_window(grid, 4, 4, 12, 12) == vector<uint32_t>{0, 1});
+        REQUIRE(ids_in_window(grid, 8, 0, 12, 8) == vector<uint32_t>{1, 2});
+        REQUIRE(ids_in_window(grid, -4, -4, 100, 100) == vector<uint32_t>{0, 1, 2, 3});
+        REQUIRE(ids_in_window(grid, 13, 13, 30, 30).empty());
+    }
+
+    SECTION("move and remove") {
+        spatial_grid grid(40, 40);
+        grid.insert(entt::entity{0}, make_tuple(1, 1));
+        grid.insert(entt::entity{1}, make_tuple(2, 2));
+
+        grid.move(entt::entity{0}, make_tuple(1, 1), make_tuple(3, 3));
+        REQUIRE(ids_in_window(grid, 1, 1, 1, 1).empty());
+        REQUIRE(ids_in_window(grid, 3, 3, 3, 3) == vector<uint32_t>{0});
+
+        grid.move(entt::entity{0}, make_tuple(3, 3), make_tuple(30, 30));
+        REQUIRE(ids_in_window(grid, 0, 0, 7, 7) == vector<uint32_t>{1});
+        REQUIRE(ids_in_window(grid, 30, 30, 30, 30) == vector<uint32_t>{0});
+
+        grid.remove(entt::entity{1}, make_tuple(2, 2));
+        REQUIRE(grid.size() == 1);
+        REQUIRE(ids_in_window(grid, 0, 0, 39, 39) == vector<uint32_t>{0});
+    }
+
+    SECTION("unregistered entities are not moved into the grid") {
+        spatial_grid grid(40, 40);
+        grid.insert(entt::entity{0}, make_tuple(1, 1));
+
+        REQUIRE(!grid.move(entt::entity{5}, make_tuple(1, 1), make_tuple(2, 2)));
+        REQUIRE(!grid.move(entt::entity{5}, make_tuple(1, 1), make_tuple(30, 30)));
+        REQUIRE(!grid.remove(entt::entity{5}, make_tuple(1, 1)));
+        REQUIRE(grid.size() == 1);
+        REQUIRE(ids_in_window(grid, 0, 0, 39, 39) == vector<uint32_t>{0});
+        REQUIRE(grid.move(entt::entity{0}, make_tuple(1, 1), make_tuple(30, 30)));
+
+        spatial_grid empty_grid;
+        REQUIRE(!empty_grid.move(entt::entity{0}, make_tuple(1, 1), make_tuple(30, 30)));
+        REQUIRE(!empty_grid.remove(entt::entity{0}, make_tuple(1, 1)));
+        REQUIRE(empty_grid.size() == 0);
+    }
+
+    SECTION("out of bounds locations are kept in edge cells") {
+        spatial_grid grid(10, 10);
+        grid.insert(entt::entity{0}, make_tuple(-2, 5));
+        grid.insert(entt::entity{1}, make_tuple(12, 12));
+
+        REQUIRE(ids_in_window(grid, -2, 5, -2, 5) == vector<uint32_t>{0});
+        REQUIRE(ids_in_window(grid, 8, 8, 12, 12) == vector<uint32_t>{1});
+        REQUIRE(ids_in_window(grid, 0, 0, 9, 9).empty());
+    }
+
+    SECTION("map helpers keep grid in sync") {
+        map_component m(20, 20, "test", {}, {}, {});
+        vector<entt::entity> npcs;
+        for(int32_t i = 0; i < 3; i++) {
+            npcs.push_back(add_npc(m, make_tuple(i * 6, i * 6), appearance_component(i, "", 0), ai_component(), entt::null, npc_component()));
+        }
+
+        remove_npc(m, npcs[0]);
+        REQUIRE(m.npc_grid.size() == 2);
+        REQUIRE(!m.entities.valid(npcs[0]));
+
+        auto found = ids_in_window(m.npc_grid, 12, 12, 12, 12);
+        REQUIRE(found == vector<uint32_t>{static_cast<uint32_t>(npcs[2])});
+        REQUIRE(m.entities.get<appearance_component>(npcs[2]).id == 2);
+
+        move_npc(m, npcs[2], make_tuple(19, 0));
+        REQUIRE(ids_in_window(m.npc_grid, 19, 0, 19, 0) == vector<uint32_t>{static_cast<uint32_t>(npcs[2])});
+        REQUIRE(m.entities.get<position_component>(npcs[2]).loc == make_tuple(19, 0));
+        REQUIRE(ids_in_window(m.npc_grid, 12, 12, 12, 12).empty());
+    }
+}
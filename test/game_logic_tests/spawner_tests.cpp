@@ -0,0 +1,194 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <game_logic/logic_helpers.h>
+#include <game_logic/map_tick.h>
+
+using namespace std;
+using namespace lotr;
+
+map_component create_spawner_test_map() {
+    uint32_t const map_size = 20;
+    array<map_layer, 15> layers;
+    vector<uint32_t> walls(map_size * map_size, 0);
+    vector<map_object> objects(map_size * map_size);
+
+    // wall off everything left of x = 10
+    for(uint32_t y = 0; y < map_size; y++) {
+        for(uint32_t x = 0; x < 10; x++) {
+            walls[x + y * map_size] = 1;
+        }
+    }
+
+    layers[map_layer_name::Walls] = map_layer(0, 0, map_size, map_size, "walls", ""s, vector<map_object>{}, move(walls));
+    layers[map_layer_name::OpaqueDecor] = map_layer(0, 0, map_size, map_size, "opaque", ""s, move(objects), vector<uint32_t>{});
+    return map_component(map_size, map_size, "test", {}, move(layers), {});
+}
+
+spawner_script create_test_spawner_script() {
+    spawner_npc_id npc_id(1, "test npc");
+    npc_id.sprite.push_back(1);
+    for(auto const &name : stat_name_table) {
+        npc_id.stats.emplace_back(string(name), 10);
+    }
+
+    spawner_script script;
+    script.loc = make_tuple(10, 10);
+    script.spawn_radius = 2;
+    script.max_creatures = 3;
+    script.respawn_rate = 5;
+    script.npc_ids.push_back(move(npc_id));
+    return script;
+}
+
+void run_ticks(map_component &m, uint32_t ticks) {
+    for(uint32_t i = 0; i < ticks; i++) {
+        m.tick++;
+        run_timers(m);
+        run_pending_respawns(m, chrono::steady_clock::time_point::max());
+    }
+}
+
+TEST_CASE("spawner tests") {
+    auto m = create_spawner_test_map();
+
+    SECTION("spawn tiles are the walkable tiles within the radius") {
+        auto spawner = add_spawner(m, create_test_spawner_script());
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+
+        REQUIRE(state.spawn_tiles.size() == 15);
+        for(auto const &loc : state.spawn_tiles) {
+            REQUIRE(tile_is_walkable(m, loc));
+            REQUIRE(get<0>(loc) >= 10);
+            REQUIRE(get<0>(loc) <= 12);
+        }
+
+        for(uint32_t i = 0; i < 3; i++) {
+            auto npc = spawn_random_npc(m, spawner);
+            REQUIRE(npc);
+            REQUIRE(tile_is_walkable(m, m.entities.get<position_component>(*npc).loc));
+        }
+    }
+
+    SECTION("counts follow spawns and deaths") {
+        auto spawner = add_spawner(m, create_test_spawner_script());
+        auto first = spawn_random_npc(m, spawner);
+        auto second = spawn_random_npc(m, spawner);
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+        REQUIRE(state.alive == 2);
+        REQUIRE(state.spawned == 2);
+
+        m.entities.get<vitals_component>(*first).hp = 0;
+        remove_dead_npcs(m);
+        REQUIRE(state.alive == 1);
+        REQUIRE(state.spawned == 2);
+        REQUIRE(m.entities.valid(*second));
+    }
+
+    SECTION("respawns after the respawn rate") {
+        m.tick_length = 500;
+        auto spawner = add_spawner(m, create_test_spawner_script());
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+        REQUIRE(state.respawn_ticks == 10);
+
+        spawn_random_npc(m, spawner);
+        schedule_respawn(m, spawner);
+        REQUIRE(m.timers.is_scheduled(spawner, RespawnTimer));
+
+        run_ticks(m, 9);
+        REQUIRE(state.alive == 1);
+        run_ticks(m, 1);
+        REQUIRE(state.alive == 2);
+        run_ticks(m, 10);
+        REQUIRE(state.alive == 3);
+
+        // full, nothing left to schedule until something dies
+        REQUIRE(!m.timers.is_scheduled(spawner, RespawnTimer));
+        run_ticks(m, 50);
+        REQUIRE(state.alive == 3);
+    }
+
+    SECTION("max spawn caps the lifetime total") {
+        auto script = create_test_spawner_script();
+        script.respawn_rate = 0;
+        script.max_spawn = 4;
+        auto spawner = add_spawner(m, move(script));
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+
+        schedule_respawn(m, spawner);
+        run_ticks(m, 5);
+        REQUIRE(state.alive == 3);
+
+        vector<entt::entity> npcs;
+        npc_group(m).each([&](entt::entity npc, position_component &, vitals_component &, ai_component &, spawner_link_component &, npc_component &) { npcs.push_back(npc); });
+        for(auto npc : npcs) {
+            remove_npc(m, npc);
+        }
+
+        run_ticks(m, 5);
+        REQUIRE(state.alive == 1);
+        REQUIRE(state.spawned == 4);
+        REQUIRE(!m.timers.is_scheduled(spawner, RespawnTimer));
+    }
+
+    SECTION("require dead to respawn waits for the last npc") {
+        auto script = create_test_spawner_script();
+        script.respawn_rate = 0;
+        script.require_dead_to_respawn = true;
+        auto spawner = add_spawner(m, move(script));
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+
+        auto first = spawn_random_npc(m, spawner);
+        auto second = spawn_random_npc(m, spawner);
+        remove_npc(m, *first);
+        run_ticks(m, 5);
+        REQUIRE(state.alive == 1);
+
+        remove_npc(m, *second);
+        run_ticks(m, 1);
+        REQUIRE(state.alive == 3);
+    }
+
+    SECTION("timers of removed spawners are ignored") {
+        auto spawner = add_spawner(m, create_test_spawner_script());
+        schedule_respawn(m, spawner);
+        m.entities.destroy(spawner);
+
+        run_ticks(m, 10);
+        REQUIRE(m.npc_grid.size() == 0);
+    }
+
+    SECTION("late respawns catch up on the respawns due in the meantime") {
+        auto script = create_test_spawner_script();
+        script.respawn_rate = 2;
+        auto spawner = add_spawner(m, move(script));
+        auto const &state = m.entities.get<spawner_state_component>(spawner);
+
+        schedule_respawn(m, spawner);
+        m.tick += 4;
+        run_timers(m);
+        run_pending_respawns(m, chrono::steady_clock::time_point::max());
+        REQUIRE(state.alive == 2);
+
+        m.tick += 100;
+        run_timers(m);
+        run_pending_respawns(m, chrono::steady_clock::time_point::max());
+        REQUIRE(state.alive == 3);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <ecs/components.h>
+#include <asset_loading/load_stats.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("stat schema tests") {
+    SECTION("names resolve to their index") {
+        for(uint32_t i = 0; i < StatCount; i++) {
+            auto id = stat_id_from_name(stat_name_table[i]);
+            REQUIRE(id);
+            REQUIRE(*id == i);
+        }
+
+        REQUIRE(stat_id_from_name(stat_hp) == StatHp);
+        REQUIRE(stat_id_from_name(stat_max_mp) == StatMaxMp);
+    }
+
+    SECTION("unknown names are rejected") {
+        REQUIRE(!stat_id_from_name("gold"));
+        REQUIRE(!stat_id_from_name(""));
+        REQUIRE(!stat_id_from_name("HP"));
+        REQUIRE(!stat_id_from_name("hpx"));
+    }
+
+    SECTION("characters start with zeroed stats") {
+        npc_component npc;
+        REQUIRE(npc.stats[StatHp] == 0);
+        npc.stats[StatHp] = -5;
+        REQUIRE(npc.stats[StatHp] == -5);
+        REQUIRE(sizeof(npc.stats) == StatCount * sizeof(int64_t));
+    }
+
+    SECTION("yaml stat nodes are visited in stat order") {
+        YAML::Node node = YAML::Load("{gold: 5, hp: 20, str: 3, HP: 7, actionSpeed: 1}");
+        vector<pair<stat_id, int64_t>> seen;
+        for_each_stat_node(node, [&seen](stat_id id, YAML::Node const &value) {
+            seen.emplace_back(id, value.as<int64_t>());
+        });
+
+        REQUIRE(seen.size() == 3);
+        REQUIRE(seen[0] == make_pair(StatStr, int64_t{3}));
+        REQUIRE(seen[1] == make_pair(StatHp, int64_t{20}));
+        REQUIRE(seen[2] == make_pair(StatActionSpeed, int64_t{1}));
+
+        uint32_t calls = 0;
+        for_each_stat_node(node["missing"], [&calls](stat_id, YAML::Node const &) { calls++; });
+        for_each_stat_node(YAML::Load("[1, 2]"), [&calls](stat_id, YAML::Node const &) { calls++; });
+        REQUIRE(calls == 0);
+    }
+}
@@ -0,0 +1,99 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <game_logic/tile_bitplanes.h>
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("tile bitplanes tests") {
+    uint32_t const map_size = 5;
+    vector<uint32_t> data(map_size * map_size, 0);
+    vector<map_object> objects(map_size * map_size);
+
+    // wall at 2,2 and an opaque decor object at 3,2
+    data[2 + 2 * map_size] = 1;
+    objects[3 + 2 * map_size].gid = 5;
+
+    map_layer walls(0, 0, map_size, map_size, "walls", ""s, vector<map_object>{}, data);
+    map_layer opaque(0, 0, map_size, map_size, "opaque", ""s, objects, {});
+
+    SECTION("walkable and opaque follow the layers") {
+        tile_bitplanes tiles(map_size, map_size, walls, opaque);
+
+        REQUIRE(tiles.walkable(0, 0));
+        REQUIRE(!tiles.opaque(0, 0));
+        REQUIRE(!tiles.walkable(2, 2));
+        REQUIRE(tiles.opaque(2, 2));
+        REQUIRE(!tiles.walkable(3, 2));
+        REQUIRE(tiles.opaque(3, 2));
+        REQUIRE(tiles.walkable(4, 4));
+    }
+
+    SECTION("out of bounds is blocked") {
+        tile_bitplanes tiles(map_size, map_size, walls, opaque);
+
+        REQUIRE(!tiles.walkable(-1, 0));
+        REQUIRE(!tiles.walkable(0, map_size));
+        REQUIRE(tiles.opaque(map_size, 0));
+        REQUIRE(tiles.opaque(0, -1));
+        REQUIRE(tiles.walkable_neighbours(-1, -1) == 0);
+    }
+
+    SECTION("neighbour mask matches walkable") {
+        tile_bitplanes tiles(map_size, map_size, walls, opaque);
+
+        for(int32_t y = 0; y < static_cast<int32_t>(map_size); y++) {
+            for(int32_t x = 0; x < static_cast<int32_t>(map_size); x++) {
+                auto mask = tiles.walkable_neighbours(x, y);
+                for(uint32_t i = 0; i < neighbour_offsets.size(); i++) {
+                    REQUIRE(((mask >> i) & 1U) == tiles.walkable(x + get<0>(neighbour_offsets[i]), y + get<1>(neighbour_offsets[i])));
+                }
+            }
+        }
+
+        // corner only has 3 neighbours
+        REQUIRE(tiles.walkable_neighbours(0, 0) == ((1U << 4U) | (1U << 6U) | (1U << 7U)));
+    }
+
+    SECTION("tiles not covered by the walls layer are blocked") {
+        tile_bitplanes tiles(map_size + 2, map_size, walls, opaque);
+
+        REQUIRE(tiles.walkable(4, 0));
+        REQUIRE(!tiles.walkable(5, 0));
+        REQUIRE(tiles.opaque(6, 0));
+    }
+
+    SECTION("an opaque layer without objects blocks nothing") {
+        map_layer empty_opaque(0, 0, map_size, map_size, "opaque", ""s, vector<map_object>{}, {});
+        REQUIRE(empty_opaque.objects.tile_count() == map_size * map_size);
+
+        // no objectgroup at all leaves a default constructed layer
+        for(auto const &opaque_layer : {empty_opaque, map_layer()}) {
+            tile_bitplanes tiles(map_size, map_size, walls, opaque_layer);
+
+            REQUIRE(tiles.walkable(0, 0));
+            REQUIRE(tiles.walkable(3, 2));
+            REQUIRE(!tiles.opaque(3, 2));
+            REQUIRE(!tiles.walkable(2, 2));
+        }
+    }
+}
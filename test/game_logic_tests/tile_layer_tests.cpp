@@ -0,0 +1,91 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <catch2/catch.hpp>
+#include <game_logic/tile_layer.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("tile layer tests") {
+    SECTION("constant layer stores no indices") {
+        tile_layer layer(vector<uint32_t>(1'000, 0));
+
+        REQUIRE(layer.size() == 1'000);
+        REQUIRE(layer.index_bytes() == 0);
+        REQUIRE(layer[0] == 0);
+        REQUIRE(layer[999] == 0);
+
+        layer.set(500, 0);
+        REQUIRE(layer.index_bytes() == 0);
+        REQUIRE(layer[500] == 0);
+    }
+
+    SECTION("index width follows the palette size") {
+        vector<uint32_t> small;
+        vector<uint32_t> medium;
+        vector<uint32_t> large;
+        for(uint32_t i = 0; i < 100'000; i++) {
+            small.push_back(i % 7 == 0 ? 3'000 + i % 5 : 0);
+            medium.push_back(i % 1'000);
+            large.push_back(i);
+        }
+
+        tile_layer small_layer(small);
+        tile_layer medium_layer(medium);
+        tile_layer large_layer(large);
+
+        REQUIRE(small_layer.index_bytes() == 1);
+        REQUIRE(medium_layer.index_bytes() == 2);
+        REQUIRE(large_layer.index_bytes() == 4);
+        REQUIRE(small_layer.decode() == small);
+        REQUIRE(medium_layer.decode() == medium);
+        REQUIRE(large_layer.decode() == large);
+        REQUIRE(small_layer.memory_usage() < small.size() * sizeof(uint32_t) / 3);
+    }
+
+    SECTION("set widens the palette when needed") {
+        vector<uint32_t> gids(300, 0);
+        tile_layer layer(gids);
+
+        layer.set(5, 12);
+        REQUIRE(layer[5] == 12);
+        REQUIRE(layer.index_bytes() == 1);
+
+        for(uint32_t i = 0; i < 300; i++) {
+            layer.set(i, 100 + i);
+        }
+        REQUIRE(layer.index_bytes() == 2);
+        for(uint32_t i = 0; i < 300; i++) {
+            REQUIRE(layer[i] == 100 + i);
+        }
+        REQUIRE_THROWS_AS(layer.set(300, 1), out_of_range);
+    }
+
+    SECTION("empty layer") {
+        tile_layer layer(vector<uint32_t>{});
+
+        REQUIRE(layer.empty());
+        REQUIRE(layer.decode().empty());
+        REQUIRE(layer[0] == 0);
+        REQUIRE(tile_layer()[0] == 0);
+        REQUIRE_THROWS_AS(layer.set(0, 5), out_of_range);
+        REQUIRE(layer.empty());
+    }
+}
@@ -0,0 +1,131 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <game_logic/timer_wheel.h>
+
+using namespace std;
+using namespace lotr;
+
+vector<uint32_t> advance_to(timer_wheel &wheel, uint64_t now) {
+    vector<uint32_t> fired;
+    wheel.advance(now, [&](timer_kind, entt::entity entity) { fired.push_back(static_cast<uint32_t>(entity)); });
+    sort(begin(fired), end(fired));
+    return fired;
+}
+
+TEST_CASE("timer wheel tests") {
+    SECTION("timers fire on their tick") {
+        timer_wheel wheel;
+        wheel.schedule(entt::entity{0}, RespawnTimer, 3);
+        wheel.schedule(entt::entity{1}, RespawnTimer, 3);
+        wheel.schedule(entt::entity{2}, RespawnTimer, 5);
+        REQUIRE(wheel.size() == 3);
+        REQUIRE(wheel.is_scheduled(entt::entity{2}, RespawnTimer));
+
+        REQUIRE(advance_to(wheel, 2).empty());
+        REQUIRE(advance_to(wheel, 3) == vector<uint32_t>{0, 1});
+        REQUIRE(advance_to(wheel, 4).empty());
+        REQUIRE(advance_to(wheel, 5) == vector<uint32_t>{2});
+        REQUIRE(wheel.size() == 0);
+        REQUIRE(!wheel.is_scheduled(entt::entity{2}, RespawnTimer));
+    }
+
+    SECTION("timers on higher levels cascade down to their tick") {
+        timer_wheel wheel;
+        vector<uint64_t> due_ticks{timer_wheel::slot_count - 1, timer_wheel::slot_count, timer_wheel::slot_count + 1, 5'000, 262'144, 300'000,
+                                   timer_wheel::wheel_span + 7};
+        for(uint32_t i = 0; i < due_ticks.size(); i++) {
+            wheel.schedule(entt::entity{i}, RespawnTimer, due_ticks[i]);
+        }
+
+        // advance in growing steps, like a map catching up after being idle
+        vector<pair<uint64_t, uint32_t>> fired;
+        for(uint64_t tick = 1; wheel.size() > 0; tick += 1 + tick / 64) {
+            wheel.advance(tick, [&](timer_kind, entt::entity entity) { fired.emplace_back(tick, static_cast<uint32_t>(entity)); });
+        }
+
+        REQUIRE(fired.size() == due_ticks.size());
+        for(uint32_t i = 0; i < fired.size(); i++) {
+            REQUIRE(fired[i].second == i);
+            REQUIRE(fired[i].first >= due_ticks[i]);
+        }
+    }
+
+    SECTION("timers fire exactly on their tick when advancing one tick at a time") {
+        timer_wheel wheel;
+        vector<uint64_t> due_ticks{1, 63, 64, 65, 4'095, 4'096, 4'097, 70'000};
+        for(uint32_t i = 0; i < due_ticks.size(); i++) {
+            wheel.schedule(entt::entity{i}, RespawnTimer, due_ticks[i]);
+        }
+
+        for(uint64_t tick = 1; tick <= 70'000; tick++) {
+            wheel.advance(tick, [&](timer_kind, entt::entity entity) { REQUIRE(due_ticks[static_cast<uint32_t>(entity)] == tick); });
+        }
+        REQUIRE(wheel.size() == 0);
+    }
+
+    SECTION("cancel and reschedule by entity") {
+        timer_wheel wheel;
+        wheel.schedule(entt::entity{0}, RespawnTimer, 10);
+        wheel.schedule(entt::entity{1}, RespawnTimer, 10);
+        wheel.schedule(entt::entity{2}, RespawnTimer, 1'000);
+
+        REQUIRE(wheel.cancel(entt::entity{0}, RespawnTimer));
+        REQUIRE(!wheel.cancel(entt::entity{0}, RespawnTimer));
+        wheel.cancel_all(entt::entity{2});
+        wheel.schedule(entt::entity{1}, RespawnTimer, 20);
+        REQUIRE(wheel.size() == 1);
+
+        REQUIRE(advance_to(wheel, 10).empty());
+        REQUIRE(advance_to(wheel, 2'000) == vector<uint32_t>{1});
+    }
+
+    SECTION("timers in the past fire on the next tick") {
+        timer_wheel wheel;
+        wheel.schedule(entt::entity{1}, RespawnTimer, 10);
+        advance_to(wheel, 10);
+        wheel.schedule(entt::entity{0}, RespawnTimer, 4);
+
+        REQUIRE(advance_to(wheel, 11) == vector<uint32_t>{0});
+    }
+
+    SECTION("callbacks can schedule and cancel") {
+        timer_wheel wheel;
+        wheel.schedule(entt::entity{0}, RespawnTimer, 1);
+        wheel.schedule(entt::entity{1}, RespawnTimer, 2);
+        wheel.schedule(entt::entity{2}, RespawnTimer, 2);
+
+        uint32_t fired = 0;
+        for(uint64_t tick = 1; tick <= 10; tick++) {
+            wheel.advance(tick, [&](timer_kind kind, entt::entity entity) {
+                fired++;
+                if(entity == entt::entity{0}) {
+                    wheel.schedule(entity, kind, tick + 2);
+                } else {
+                    // whichever of 1 and 2 runs first cancels the other
+                    wheel.cancel(entt::entity{1}, kind);
+                    wheel.cancel(entt::entity{2}, kind);
+                }
+            });
+        }
+
+        REQUIRE(fired == 6);
+        REQUIRE(wheel.size() == 1);
+    }
+}
@@ -0,0 +1,64 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include "../test_helpers/startup_helper.h"
+#include <game_queue_message_handlers/game_queue_dispatch.h>
+#include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("game queue dispatch tests") {
+    SECTION( "bulk dequeued messages reach their handlers in order" ) {
+        entt::registry registry;
+
+        auto new_entity = registry.create();
+        {
+            map_component test_map(10, 10, "test", {}, {}, {});
+            registry.assign<map_component>(new_entity, move(test_map));
+        }
+        auto player = add_player_to_game(registry, new_entity, make_tuple(1, 1), appearance_component(1, "test_player", 0), 1, pc_component());
+
+        moodycamel::ConcurrentQueue<queue_message> q;
+        q.enqueue(player_resync_message(1));
+        q.enqueue(player_move_message(1, 20, 30));
+        q.enqueue(player_leave_message(1));
+
+        moodycamel::ConsumerToken token(q);
+        vector<queue_message> messages;
+        while (q.try_dequeue_bulk(token, back_inserter(messages), 2) > 0) {}
+        REQUIRE(messages.size() == 3);
+        REQUIRE(holds_alternative<player_move_message>(messages[1]));
+
+        outward_queues outward_queue;
+        auto &test_map = registry.get<map_component>(new_entity);
+        test_map.entities.get<connection_component>(player).keyframe_requested = false;
+
+        dispatch_game_queue_message(messages[0], registry, outward_queue);
+        REQUIRE(test_map.entities.get<connection_component>(player).keyframe_requested);
+
+        dispatch_game_queue_message(messages[1], registry, outward_queue);
+        REQUIRE(outward_queue.size_approx() == 1);
+        REQUIRE(test_map.entities.get<position_component>(player).loc == make_tuple(1, 1));
+
+        dispatch_game_queue_message(messages[2], registry, outward_queue);
+        REQUIRE(test_map.entities.size<connection_component>() == 0);
+    }
+}
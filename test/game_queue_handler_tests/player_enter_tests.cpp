@@ -20,6 +20,7 @@
 #include "../test_helpers/startup_helper.h"
 #include <game_queue_message_handlers/player_enter_handler.h>
 #include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
 
 using namespace std;
 using namespace lotr;
@@ -37,20 +38,50 @@ TEST_CASE("character enter tests") {
         }
 
         player_enter_message msg("test_player", "gender", "allegiance", "class", "test", {}, 1, 2, 3, 4, 5);
-        handle_player_enter_message(&msg, registry, q);
+        handle_player_enter_message(msg, registry, q);
 
         auto &test_map = registry.get<map_component>(new_entity);
 
-        REQUIRE(test_map.players.size() == 1);
-        REQUIRE(test_map.players[0].name == "test_player");
-        REQUIRE(test_map.players[0].gender == "gender");
-        REQUIRE(test_map.players[0].allegiance == "allegiance");
-        REQUIRE(test_map.players[0].character_class == "class");
-        REQUIRE(test_map.players[0].connection_id == 1);
-        REQUIRE(test_map.players[0].level == 2);
-        REQUIRE(test_map.players[0].gold == 3);
-        REQUIRE(get<0>(test_map.players[0].loc) == 4);
-        REQUIRE(get<1>(test_map.players[0].loc) == 5);
+        REQUIRE(test_map.entities.size<connection_component>() == 1);
+
+        auto handle = find_player_by_connection(registry, 1);
+        REQUIRE(handle);
+        REQUIRE(handle->map_entity == new_entity);
+
+        auto player = handle->entity;
+        auto const &pc = test_map.entities.get<pc_component>(player);
+        REQUIRE(test_map.entities.get<appearance_component>(player).name == "test_player");
+        REQUIRE(pc.gender.str() == "gender");
+        REQUIRE(pc.allegiance.str() == "allegiance");
+        REQUIRE(pc.character_class.str() == "class");
+        REQUIRE(test_map.entities.get<connection_component>(player).connection_id == 1);
+        REQUIRE(pc.level == 2);
+        REQUIRE(pc.gold == 3);
+        REQUIRE(get<0>(test_map.entities.get<position_component>(player).loc) == 4);
+        REQUIRE(get<1>(test_map.entities.get<position_component>(player).loc) == 5);
+        REQUIRE(find_player_by_name(registry, "test_player"));
+    }
+
+    SECTION( "character already in game does not enter twice" ) {
+        entt::registry registry;
+
+        auto new_entity = registry.create();
+        {
+            map_component test_map(10, 10, "test", {}, {}, {});
+
+            registry.assign<map_component>(new_entity, move(test_map));
+        }
+
+        player_enter_message msg("test_player", "gender", "allegiance", "class", "test", {}, 1, 2, 3, 4, 5);
+        handle_player_enter_message(msg, registry, q);
+        player_enter_message msg2("test_player", "gender", "allegiance", "class", "test", {}, 2, 2, 3, 4, 5);
+        handle_player_enter_message(msg2, registry, q);
+
+        auto &test_map = registry.get<map_component>(new_entity);
+
+        REQUIRE(test_map.entities.size<connection_component>() == 1);
+        REQUIRE(find_player_by_connection(registry, 1));
+        REQUIRE(!find_player_by_connection(registry, 2));
     }
 
     SECTION( "character does not enter non-existing world" ) {
@@ -64,11 +95,11 @@ TEST_CASE("character enter tests") {
         }
 
         player_enter_message msg("test_player", "gender", "allegiance", "class", "wrong_map", {}, 1, 2, 3, 4, 5);
-        handle_player_enter_message(&msg, registry, q);
+        handle_player_enter_message(msg, registry, q);
 
         auto &test_map = registry.get<map_component>(new_entity);
 
-        REQUIRE(test_map.players.size() == 0);
+        REQUIRE(test_map.entities.size<connection_component>() == 0);
     }
 
     SECTION( "character does not enter world with wrong coordinates" ) {
@@ -81,10 +112,10 @@ TEST_CASE("character enter tests") {
             registry.assign<map_component>(new_entity, move(test_map));
         }
         player_enter_message msg("test_player", "gender", "allegiance", "class", "test", {}, 1, 20, 30, 40, 50);
-        handle_player_enter_message(&msg, registry, q);
+        handle_player_enter_message(msg, registry, q);
 
         auto &test_map = registry.get<map_component>(new_entity);
 
-        REQUIRE(test_map.players.size() == 0);
+        REQUIRE(test_map.entities.size<connection_component>() == 0);
     }
 }
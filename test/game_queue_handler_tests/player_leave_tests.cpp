@@ -20,6 +20,7 @@
 #include "../test_helpers/startup_helper.h"
 #include <game_queue_message_handlers/player_leave_handler.h>
 #include <ecs/components.h>
+#include <game_logic/logic_helpers.h>
 
 using namespace std;
 using namespace lotr;
@@ -31,20 +32,44 @@ TEST_CASE("character leave tests") {
         auto new_entity = registry.create();
         {
             map_component test_map(10, 10, "test", {}, {}, {});
-            pc_component pc;
-            pc.connection_id = 1;
-            pc.name = "test_player";
-            test_map.players.emplace_back(move(pc));
-
             registry.assign<map_component>(new_entity, move(test_map));
         }
+        add_player_to_game(registry, new_entity, make_tuple(0, 0), appearance_component(1, "test_player", 0), 1, pc_component());
 
         outward_queues q;
         player_leave_message msg(1);
-        handle_player_leave_message(&msg, registry, q);
+        handle_player_leave_message(msg, registry, q);
 
         auto &test_map = registry.get<map_component>(new_entity);
 
-        REQUIRE(test_map.players.size() == 0);
+        REQUIRE(test_map.entities.size<connection_component>() == 0);
+        REQUIRE(test_map.player_grid.size() == 0);
+        REQUIRE(test_map.player_connections.empty());
+        REQUIRE(!find_player_by_connection(registry, 1));
+        REQUIRE(!find_player_by_name(registry, "test_player"));
+    }
+
+    SECTION( "index is unaffected by other players leaving" ) {
+        entt::registry registry;
+
+        auto new_entity = registry.create();
+        {
+            map_component test_map(10, 10, "test", {}, {}, {});
+            registry.assign<map_component>(new_entity, move(test_map));
+        }
+        vector<entt::entity> players;
+        for(uint64_t conn = 1; conn <= 3; conn++) {
+            players.push_back(add_player_to_game(registry, new_entity, make_tuple(0, 0), appearance_component(conn, "player" + to_string(conn), 0), conn, pc_component()));
+        }
+
+        outward_queues q;
+        handle_player_leave_message(player_leave_message(1), registry, q);
+
+        auto handle = find_player_by_name(registry, "player3");
+        REQUIRE(handle);
+        REQUIRE(handle->entity == players[2]);
+        REQUIRE(handle->m->entities.get<connection_component>(handle->entity).connection_id == 3);
+        REQUIRE(find_player_by_connection(registry, 2)->entity == players[1]);
+        REQUIRE(!find_player_by_connection(registry, 1));
     }
 }
@@ -0,0 +1,263 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <messages/binary_codec.h>
+#include <messages/user_access/login_request.h>
+#include <messages/user_access/login_response.h>
+#include <messages/user_access/character_select_request.h>
+#include <messages/user_access/character_select_response.h>
+#include <messages/chat/message_response.h>
+#include <messages/map_update_response.h>
+#include <messages/map_delta_response.h>
+#include <messages/batch_response.h>
+
+#include <ecs/components.h>
+
+using namespace std;
+using namespace lotr;
+
+#define SERDE_BINARY(type, id, ...) type msg{__VA_ARGS__}; \
+            auto ser = msg.serialize_binary(); \
+            binary_reader reader(ser); \
+            binary_message_id read_id{}; \
+            REQUIRE(reader.read_header(read_id)); \
+            REQUIRE(read_id == id); \
+            auto msg2 = type::deserialize_binary(reader); \
+            REQUIRE(msg2); \
+            REQUIRE(reader.at_end());
+
+TEST_CASE("binary message serialization tests") {
+    SECTION("codec primitives") {
+        binary_writer writer(LoginRequest);
+        writer.write_u8(250);
+        writer.write_bool(true);
+        writer.write_u16(60'000);
+        writer.write_u32(4'000'000'000);
+        writer.write_u64(0xFFFF'FFFF'FFFF'FFF0);
+        writer.write_i32(-123);
+        writer.write_i64(-1'234'567'890'123);
+        writer.write_count(300);
+        writer.write_string("héllo");
+        auto ser = writer.release();
+
+        // header is version + little-endian id
+        REQUIRE(ser.size() > 3);
+        REQUIRE(static_cast<uint8_t>(ser[0]) == binary_protocol_version);
+        REQUIRE(static_cast<uint8_t>(ser[1]) == LoginRequest);
+        REQUIRE(static_cast<uint8_t>(ser[2]) == 0);
+
+        binary_reader reader(ser);
+        binary_message_id id{};
+        REQUIRE(reader.read_header(id));
+        REQUIRE(id == LoginRequest);
+        REQUIRE(reader.read_u8() == 250);
+        REQUIRE(reader.read_bool());
+        REQUIRE(reader.read_u16() == 60'000);
+        REQUIRE(reader.read_u32() == 4'000'000'000);
+        REQUIRE(reader.read_u64() == 0xFFFF'FFFF'FFFF'FFF0);
+        REQUIRE(reader.read_i32() == -123);
+        REQUIRE(reader.read_i64() == -1'234'567'890'123);
+        // count larger than the remaining bytes is rejected
+        REQUIRE(reader.read_count() == 0);
+        REQUIRE(!reader.ok());
+    }
+
+    SECTION("truncated and foreign frames fail") {
+        login_request msg("user", "password");
+        auto ser = msg.serialize_binary();
+
+        binary_reader truncated(string_view(ser).substr(0, ser.size() - 2));
+        binary_message_id id{};
+        REQUIRE(truncated.read_header(id));
+        REQUIRE(!login_request::deserialize_binary(truncated));
+
+        ser[0] = binary_protocol_version + 1;
+        binary_reader wrong_version(ser);
+        REQUIRE(!wrong_version.read_header(id));
+
+        binary_reader empty(""sv);
+        REQUIRE(!empty.read_header(id));
+    }
+
+    SECTION("login request") {
+        SERDE_BINARY(login_request, LoginRequest, "user", "password");
+        REQUIRE(msg.username == msg2->username);
+        REQUIRE(msg.password == msg2->password);
+    }
+
+    SECTION("login response") {
+        vector<character_object> players;
+        vector<stat_component> stats;
+        stats.emplace_back("str", 12);
+        vector<item_object> items;
+        items.emplace_back(1, 2, 3, "name", "desc", "sprite", vector<stat_component>{});
+        vector<skill_object> skills;
+        skills.emplace_back("sword", 3);
+        players.emplace_back("name", "gender",  "allegiance", "baseclass", "map", 1, 9, 2, 5, 7, stats, items, skills);
+        vector<account_object> users;
+        users.emplace_back(false, true, false, 123, 456, "user1");
+        SERDE_BINARY(login_response, LoginResponse, move(players), move(users), "username", "email", "motd");
+        REQUIRE(msg2->players.size() == 1);
+        REQUIRE(msg2->online_users.size() == 1);
+        REQUIRE(msg.username == msg2->username);
+        REQUIRE(msg.email == msg2->email);
+        REQUIRE(msg.motd == msg2->motd);
+        REQUIRE(msg.players[0].name == msg2->players[0].name);
+        REQUIRE(msg.players[0].map_name == msg2->players[0].map_name);
+        REQUIRE(msg.players[0].level == msg2->players[0].level);
+        REQUIRE(msg.players[0].gold == msg2->players[0].gold);
+        REQUIRE(msg.players[0].x == msg2->players[0].x);
+        REQUIRE(msg.players[0].y == msg2->players[0].y);
+        REQUIRE(msg2->players[0].stats.size() == 1);
+        REQUIRE(msg2->players[0].stats[0].value == 12);
+        REQUIRE(msg2->players[0].items.size() == 1);
+        REQUIRE(msg2->players[0].items[0].name == "name");
+        REQUIRE(msg2->players[0].skills.size() == 1);
+        REQUIRE(msg2->players[0].skills[0].value == 3);
+        REQUIRE(msg.online_users[0].trial_ends_unix_timestamp == msg2->online_users[0].trial_ends_unix_timestamp);
+        REQUIRE(msg.online_users[0].subscription_tier == msg2->online_users[0].subscription_tier);
+        REQUIRE(msg.online_users[0].username == msg2->online_users[0].username);
+    }
+
+    SECTION("character select request") {
+        SERDE_BINARY(character_select_request, CharacterSelectRequest);
+    }
+
+    SECTION("character select response") {
+        vector<stat_component> base_stats;
+        base_stats.emplace_back("test", 123);
+        vector<character_allegiance> allegiances;
+        allegiances.emplace_back("test5", "test6", base_stats, vector<item_object>{}, vector<skill_object>{});
+        vector<character_class> classes;
+        classes.emplace_back("test8", "test9", base_stats);
+        SERDE_BINARY(character_select_response, CharacterSelectResponse, base_stats, allegiances, classes);
+        REQUIRE(msg2->base_stats.size() == 1);
+        REQUIRE(msg2->base_stats[0].name == "test");
+        REQUIRE(msg2->base_stats[0].value == 123);
+        REQUIRE(msg2->allegiances.size() == 1);
+        REQUIRE(msg2->allegiances[0].name == "test5");
+        REQUIRE(msg2->allegiances[0].stat_mods.size() == 1);
+        REQUIRE(msg2->classes.size() == 1);
+        REQUIRE(msg2->classes[0].description == "test9");
+        REQUIRE(msg2->classes[0].stat_mods.size() == 1);
+    }
+
+    SECTION("message response") {
+        SERDE_BINARY(message_response, MessageResponse, "user", "content", "source", 1234);
+        REQUIRE(msg.user == msg2->user);
+        REQUIRE(msg.content == msg2->content);
+        REQUIRE(msg.source == msg2->source);
+        REQUIRE(msg.unix_timestamp == msg2->unix_timestamp);
+    }
+
+    SECTION("map update response") {
+        vector<map_delta_entity> npcs;
+        npcs.emplace_back(7, "test", 1, make_tuple(2, 3));
+        SERDE_BINARY(map_update_response, MapUpdateResponse, npcs);
+        REQUIRE(msg2->npcs.size() == 1);
+        REQUIRE(msg2->npcs[0].id == 7);
+        REQUIRE(msg2->npcs[0].name == "test");
+        REQUIRE(msg2->npcs[0].sprite == 1);
+        REQUIRE(msg2->npcs[0].loc == make_tuple(2, 3));
+    }
+
+    SECTION("map delta response") {
+        vector<map_delta_entity> entered;
+        entered.emplace_back(1, "npc", 5, make_tuple(-1, 2));
+        vector<map_delta_move> moved;
+        moved.emplace_back(2, make_tuple(3, 4));
+        SERDE_BINARY(map_delta_response, MapDeltaResponse, entered, vector<map_delta_entity>{}, moved, vector<uint64_t>{7, 8});
+        REQUIRE(msg2->entered.size() == 1);
+        REQUIRE(msg2->entered[0].id == 1);
+        REQUIRE(msg2->entered[0].name == "npc");
+        REQUIRE(msg2->entered[0].sprite == 5);
+        REQUIRE(msg2->entered[0].loc == make_tuple(-1, 2));
+        REQUIRE(msg2->changed.empty());
+        REQUIRE(msg2->moved.size() == 1);
+        REQUIRE(msg2->moved[0].loc == make_tuple(3, 4));
+        REQUIRE(msg2->left == vector<uint64_t>{7, 8});
+    }
+
+    SECTION("coalesce by connection") {
+        vector<outward_message> messages;
+        messages.emplace_back(2, make_unique<message_response>("a", "first", "source", 1));
+        messages.emplace_back(1, make_unique<message_response>("b", "only", "source", 2));
+        messages.emplace_back(2, make_unique<message_response>("a", "second", "source", 3));
+        coalesce_by_connection(messages);
+
+        REQUIRE(messages.size() == 2);
+        REQUIRE(messages[0].conn_id == 1);
+        REQUIRE(dynamic_cast<message_response*>(messages[0].msg.get()) != nullptr);
+        REQUIRE(messages[1].conn_id == 2);
+        auto batch = dynamic_cast<batch_response*>(messages[1].msg.get());
+        REQUIRE(batch != nullptr);
+        REQUIRE(batch->messages.size() == 2);
+
+        auto ser = batch->serialize_binary();
+        binary_reader reader(ser);
+        binary_message_id id{};
+        REQUIRE(reader.read_header(id));
+        REQUIRE(id == BatchResponse);
+        REQUIRE(reader.read_count() == 2);
+        for(auto const &content : {"first"s, "second"s}) {
+            auto frame = reader.read_string();
+            binary_reader inner(frame);
+            REQUIRE(inner.read_header(id));
+            REQUIRE(id == MessageResponse);
+            auto msg = message_response::deserialize_binary(inner);
+            REQUIRE(msg);
+            REQUIRE(msg->content == content);
+        }
+        REQUIRE(reader.at_end());
+    }
+
+    SECTION("batch without binary encoding falls back to json") {
+        vector<unique_ptr<message>> messages;
+        messages.push_back(make_unique<message_response>("a", "first", "source", 1));
+        messages.push_back(make_unique<character_select_request>());
+        REQUIRE(!batch_response(move(messages)).serialize_binary().empty());
+
+        struct json_only : message {
+            string serialize() const override { return "{}"; }
+        };
+        vector<unique_ptr<message>> mixed;
+        mixed.push_back(make_unique<message_response>("a", "first", "source", 1));
+        mixed.push_back(make_unique<json_only>());
+        REQUIRE(batch_response(move(mixed)).serialize_binary().empty());
+    }
+
+    SECTION("every schema type is a primitive or defined in the schema") {
+        vector<string> const primitives = {"bool", "u8", "u16", "u32", "u64", "i32", "i64", "string"};
+        auto defined = [&](string const &type) {
+            return find(begin(primitives), end(primitives), type) != end(primitives) ||
+                   any_of(begin(binary_schema), end(binary_schema), [&type](binary_schema_entry const &e) { return e.id == 0 && e.name == type; });
+        };
+
+        for(auto const &entry : binary_schema) {
+            for(auto const &field : entry.fields) {
+                auto type = field.type;
+                if(type.rfind("array<", 0) == 0) {
+                    type = type.substr(6, type.size() - 7);
+                }
+                INFO(entry.name << "." << field.name << ": " << field.type);
+                REQUIRE(defined(type));
+            }
+        }
+    }
+}
@@ -31,7 +31,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short usernames") {
         string message = register_request("a", "okay_password", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -50,7 +50,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short usernames utf8") {
         string message = register_request("漢", "okay_password", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -69,7 +69,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too long usernames") {
         string message = register_request("aalishdiquwhgebilugfhkjsdhasdasd", "okay_password", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -88,7 +88,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short password") {
         string message = register_request("ab", "shortpw", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -107,7 +107,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit too short password utf8") {
         string message = register_request("ab", "漢字漢字漢字", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -126,7 +126,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit password equal to username") {
         string message = register_request("okay_p$ssword", "okay_p$ssword", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -145,7 +145,7 @@ TEST_CASE("register handler tests") {
     SECTION("Prohibit password equal to email") {
         string message = register_request("ab", "an_email", "an_email").serialize();
         per_socket_data<uint64_t> user_data;
-        moodycamel::ConcurrentQueue<unique_ptr<queue_message>> q;
+        moodycamel::ConcurrentQueue<queue_message> q;
         lotr_flat_map<uint64_t, per_socket_data<uint64_t>> user_connections;
         custom_server s;
         user_data.ws = 1;
@@ -36,6 +36,11 @@
 #include <messages/moderator/set_motd_request.h>
 #include <messages/moderator/update_motd_response.h>
 #include <messages/map_update_response.h>
+#include <messages/map_delta_response.h>
+#include <messages/commands/resync_request.h>
+#include <messages/protocol/negotiate_request.h>
+#include <messages/protocol/negotiate_response.h>
+#include <messages/batch_response.h>
 #include <messages/generic_error_response.h>
 #include <messages/generic_ok_response.h>
 
@@ -250,6 +255,11 @@ TEST_CASE("message serialization tests") {
         REQUIRE(msg.y == msg2->y);
     }
 
+    SECTION("resync request") {
+        SERDE_SINGLE(resync_request);
+        REQUIRE(msg2);
+    }
+
     // chat
 
     SECTION("message request") {
@@ -280,27 +290,74 @@ TEST_CASE("message serialization tests") {
     // misc
 
     SECTION("map update response") {
-        vector<character_component> npcs;
-        character_component one;
-        one.name = "test";
-        one.sprite = 1;
-        one.loc = make_tuple(2, 3);
-
-        character_component two;
-        two.name = "test2";
-        two.sprite = 4;
-        one.loc = make_tuple(5, 6);
-        npcs.push_back(one);
-        npcs.push_back(two);
+        vector<map_delta_entity> npcs;
+        npcs.emplace_back(7, "test", 1, make_tuple(5, 6));
+        npcs.emplace_back(8, "test2", 4, make_tuple(0, 0));
         SERDE(map_update_response, npcs)
         REQUIRE(msg.npcs.size() == msg2->npcs.size());
         for(uint32_t i = 0; i < msg.npcs.size(); i++) {
+            REQUIRE(msg.npcs[i].id == msg2->npcs[i].id);
             REQUIRE(msg.npcs[i].name == msg2->npcs[i].name);
             REQUIRE(msg.npcs[i].sprite == msg2->npcs[i].sprite);
             REQUIRE(msg.npcs[i].loc == msg2->npcs[i].loc);
         }
     }
 
+    SECTION("map delta response") {
+        vector<map_delta_entity> entered{map_delta_entity(1, "test", 2, make_tuple(3, 4))};
+        vector<map_delta_entity> changed{map_delta_entity(5, "test2", 6, make_tuple(7, 8))};
+        vector<map_delta_move> moved{map_delta_move(9, make_tuple(10, 11))};
+        vector<uint64_t> left{12, 13};
+        SERDE(map_delta_response, entered, changed, moved, left)
+        REQUIRE(msg2->entered.size() == 1);
+        REQUIRE(msg2->entered[0].id == 1);
+        REQUIRE(msg2->entered[0].name == "test");
+        REQUIRE(msg2->entered[0].sprite == 2);
+        REQUIRE(msg2->entered[0].loc == make_tuple(3, 4));
+        REQUIRE(msg2->changed.size() == 1);
+        REQUIRE(msg2->changed[0].id == 5);
+        REQUIRE(msg2->changed[0].loc == make_tuple(7, 8));
+        REQUIRE(msg2->moved.size() == 1);
+        REQUIRE(msg2->moved[0].id == 9);
+        REQUIRE(msg2->moved[0].loc == make_tuple(10, 11));
+        REQUIRE(msg2->left == left);
+    }
+
+    // protocol
+
+    SECTION("negotiate request") {
+        SERDE(negotiate_request, "binary", 1);
+        REQUIRE(msg.encoding == msg2->encoding);
+        REQUIRE(msg.version == msg2->version);
+    }
+
+    SECTION("negotiate response") {
+        SERDE(negotiate_response, "binary", 1, binary_schema);
+        REQUIRE(msg.encoding == msg2->encoding);
+        REQUIRE(msg.version == msg2->version);
+        REQUIRE(msg.schema.size() == msg2->schema.size());
+        for(uint32_t i = 0; i < msg.schema.size(); i++) {
+            REQUIRE(msg.schema[i].id == msg2->schema[i].id);
+            REQUIRE(msg.schema[i].name == msg2->schema[i].name);
+            REQUIRE(msg.schema[i].fields.size() == msg2->schema[i].fields.size());
+        }
+    }
+
+    SECTION("batch response") {
+        vector<unique_ptr<message>> messages;
+        messages.push_back(make_unique<message_response>("user", "content", "source", 1234));
+        messages.push_back(make_unique<generic_ok_response>("ok"));
+        batch_response msg(move(messages));
+        rapidjson::Document d;
+        auto ser = msg.serialize();
+        d.Parse(ser.c_str(), ser.size());
+        REQUIRE(!d.HasParseError());
+        REQUIRE(d["type"].GetString() == batch_response::type);
+        REQUIRE(d["messages"].Size() == 2);
+        REQUIRE(d["messages"][0u]["type"].GetString() == message_response::type);
+        REQUIRE(d["messages"][1u]["type"].GetString() == generic_ok_response::type);
+    }
+
     SECTION("generic error response") {
         SERDE(generic_error_response, "err", "name", "desc", true);
         REQUIRE(msg.error == msg2->error);
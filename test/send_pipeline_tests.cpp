@@ -0,0 +1,117 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <future>
+#include <send_pipeline.h>
+#include <messages/generic_ok_response.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("send pipeline tests") {
+    SECTION("messages per connection keep their order") {
+        mutex sent_mutex;
+        vector<vector<string>> sent(8);
+        send_pipeline sender(3, [&](vector<outward_message> &messages) {
+            unique_lock lock(sent_mutex);
+            for(auto &msg : messages) {
+                sent[msg.conn_id].push_back(dynamic_cast<generic_ok_response*>(msg.msg.get())->message);
+            }
+        });
+
+        for(uint32_t tick = 0; tick < 50; tick++) {
+            vector<outward_message> messages;
+            for(uint64_t conn = 0; conn < sent.size(); conn++) {
+                messages.emplace_back(conn, make_unique<generic_ok_response>(to_string(tick)));
+            }
+            sender.submit(messages);
+            REQUIRE(messages.empty());
+        }
+        sender.flush();
+
+        REQUIRE(sender.thread_count() == 3);
+        for(auto &conn : sent) {
+            REQUIRE(conn.size() == 50);
+            for(uint32_t tick = 0; tick < 50; tick++) {
+                REQUIRE(conn[tick] == to_string(tick));
+            }
+        }
+    }
+
+    SECTION("pending messages are sent on destruction") {
+        atomic<uint32_t> count{0};
+        {
+            send_pipeline sender(2, [&](vector<outward_message> &messages) { count += messages.size(); });
+            vector<outward_message> messages;
+            for(uint64_t conn = 0; conn < 100; conn++) {
+                messages.emplace_back(conn, make_unique<generic_ok_response>("ok"));
+            }
+            sender.submit(messages);
+        }
+
+        REQUIRE(count == 100);
+    }
+
+    SECTION("connections over the pending cap are dropped and reported once") {
+        mutex gate;
+        unique_lock hold(gate);
+        promise<void> entered;
+        auto entered_future = entered.get_future();
+        atomic<bool> first{true};
+        atomic<uint32_t> sent{0};
+        vector<uint64_t> overflowed;
+        send_pipeline sender(1, [&](vector<outward_message> &messages) {
+            if(first.exchange(false)) {
+                entered.set_value();
+            }
+            unique_lock wait(gate);
+            sent += messages.size();
+        }, 10, [&](uint64_t conn_id) { overflowed.push_back(conn_id); });
+
+        // the worker is stuck sending the first message, so everything after it stays pending
+        vector<outward_message> messages;
+        messages.emplace_back(1, make_unique<generic_ok_response>("first"));
+        sender.submit(messages);
+        entered_future.wait();
+
+        for(uint32_t tick = 0; tick < 3; tick++) {
+            for(uint32_t i = 0; i < 8; i++) {
+                messages.emplace_back(1, make_unique<generic_ok_response>("slow"));
+            }
+            messages.emplace_back(2, make_unique<generic_ok_response>("fast"));
+            sender.submit(messages);
+        }
+
+        REQUIRE(overflowed == vector<uint64_t>{1});
+        REQUIRE(sender.dropped() == 14);
+
+        hold.unlock();
+        sender.flush();
+        REQUIRE(sent == 1 + 10 + 3);
+
+        // the cap applies to what is pending, a drained connection can queue again
+        for(uint32_t i = 0; i < 5; i++) {
+            messages.emplace_back(1, make_unique<generic_ok_response>("again"));
+        }
+        sender.submit(messages);
+        sender.flush();
+        REQUIRE(sent == 19);
+        REQUIRE(overflowed.size() == 1);
+    }
+}
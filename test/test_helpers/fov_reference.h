@@ -0,0 +1,28 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <game_logic/fov.h>
+
+namespace lotr {
+    // fov as it was before fixed point slopes, double precision with map sized scratch per thread
+    [[nodiscard]]
+    bitset<power(fov_diameter)> compute_fov_double_reference(map_component const &m, location const &player_loc, bool const light_walls);
+}
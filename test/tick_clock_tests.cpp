@@ -0,0 +1,57 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019 Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <tick_clock.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("tick clock tests") {
+    SECTION("waits until the tick is due") {
+        tick_clock clock(chrono::milliseconds(5), chrono::microseconds(500));
+        auto const scheduled = clock.next_tick();
+
+        auto const lateness = clock.wait_for_next_tick();
+        auto const now = chrono::steady_clock::now();
+        REQUIRE(now >= scheduled);
+        REQUIRE(lateness >= chrono::nanoseconds(0));
+        REQUIRE(lateness <= now - scheduled);
+    }
+
+    SECTION("advance keeps the schedule") {
+        tick_clock clock(chrono::milliseconds(10), chrono::microseconds(0));
+        auto const first = clock.next_tick();
+
+        REQUIRE(clock.advance(first + chrono::milliseconds(3)) == 0);
+        REQUIRE(clock.next_tick() == first + chrono::milliseconds(10));
+
+        // running late by less than a tick catches up without dropping
+        REQUIRE(clock.advance(first + chrono::milliseconds(25)) == 0);
+        REQUIRE(clock.next_tick() == first + chrono::milliseconds(20));
+    }
+
+    SECTION("ticks missed by more than a tick are dropped") {
+        tick_clock clock(chrono::milliseconds(10), chrono::microseconds(0));
+        auto const first = clock.next_tick();
+
+        // the ticks at 10 to 40 are dropped and the one at 50 runs right away
+        REQUIRE(clock.advance(first + chrono::milliseconds(55)) == 4);
+        REQUIRE(clock.next_tick() == first + chrono::milliseconds(50));
+    }
+}
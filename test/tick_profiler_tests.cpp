@@ -0,0 +1,86 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019  Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <metrics/latency_histogram.h>
+#include <metrics/tick_profiler.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("tick profiler tests") {
+    SECTION("small values are exact") {
+        latency_histogram h;
+        for(uint64_t i = 1; i <= 50; i++) {
+            h.record(i);
+        }
+
+        REQUIRE(h.total() == 50);
+        REQUIRE(h.value_at_percentile(50) == 25);
+        REQUIRE(h.value_at_percentile(100) == 50);
+        REQUIRE(h.max_recorded() == 50);
+    }
+
+    SECTION("large values stay within precision") {
+        latency_histogram h;
+        for(uint64_t i = 1; i <= 100'000; i++) {
+            h.record(i * 1'000);
+        }
+
+        auto p50 = h.value_at_percentile(50);
+        auto p99 = h.value_at_percentile(99);
+        auto p999 = h.value_at_percentile(99.9);
+        REQUIRE(p50 >= 50'000'000);
+        REQUIRE(p50 <= 50'000'000 * 1.04);
+        REQUIRE(p99 >= 99'000'000);
+        REQUIRE(p99 <= 99'000'000 * 1.04);
+        REQUIRE(p999 >= 99'900'000);
+        REQUIRE(p999 <= 100'000'000);
+    }
+
+    SECTION("bucket index is monotonic and in range") {
+        uint32_t last = 0;
+        for(uint64_t v = 0; v < 1'000'000; v += 7) {
+            auto idx = latency_histogram::bucket_index(v);
+            REQUIRE(idx >= last);
+            REQUIRE(idx < latency_histogram::bucket_count);
+            REQUIRE(latency_histogram::bucket_upper_value(idx) >= v);
+            last = idx;
+        }
+        REQUIRE(latency_histogram::bucket_index(latency_histogram::max_value) == latency_histogram::bucket_count - 1);
+    }
+
+    SECTION("profiler keeps maps apart") {
+        tick_profiler profiler({"a"s, "b"s});
+        tick_phase_timings timings{};
+        timings[Fov] = 10;
+        timings[Total] = 20;
+        profiler.record_map_tick(1, timings);
+        profiler.record_tick(timings);
+
+        REQUIRE(profiler.map_histogram(0, Fov).total() == 0);
+        REQUIRE(profiler.map_histogram(1, Fov).total() == 1);
+        REQUIRE(profiler.map_histogram(1, Fov).max_recorded() == 10);
+        REQUIRE(profiler.tick_histogram(Total).max_recorded() == 20);
+
+        profiler.publish();
+
+        REQUIRE(profiler.map_histogram(1, Fov).total() == 0);
+        REQUIRE(profiler.tick_histogram(Total).total() == 0);
+    }
+}
@@ -0,0 +1,62 @@
+/*
+    Land of the Rair
+    Copyright (C) 2019  Michael de Lang
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU Affero General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU Affero General Public License for more details.
+
+    You should have received a copy of the GNU Affero General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <catch2/catch.hpp>
+#include <work_stealing_pool.h>
+
+using namespace std;
+using namespace lotr;
+
+TEST_CASE("work stealing pool tests") {
+    SECTION("every task runs exactly once") {
+        work_stealing_pool pool(3);
+        vector<atomic<uint32_t>> runs(1'000);
+
+        for(uint32_t batch = 0; batch < 10; batch++) {
+            pool.run_and_wait(runs.size(), [&](uint32_t i) { runs[i]++; });
+        }
+
+        for(auto &run : runs) {
+            REQUIRE(run == 10);
+        }
+    }
+
+    SECTION("uneven tasks get stolen") {
+        work_stealing_pool pool(3);
+        atomic<uint32_t> done{0};
+
+        pool.run_and_wait(8, [&](uint32_t i) {
+            if(i == 0) {
+                this_thread::sleep_for(chrono::milliseconds(20));
+            }
+            done++;
+        });
+
+        REQUIRE(done == 8);
+    }
+
+    SECTION("no worker threads runs on caller") {
+        work_stealing_pool pool(0);
+        uint32_t sum = 0;
+
+        pool.run_and_wait(100, [&](uint32_t i) { sum += i; });
+
+        REQUIRE(pool.thread_count() == 0);
+        REQUIRE(sum == 4950);
+    }
+}